@@ -13,10 +13,18 @@ const char APP_COPYRIGHT[] = "Copyright © 2018, Vladimir Zarypov";
 const char WORKSPACE_DIRECTORY[] = "RustProjects";
 const char PROJECT_DATA_DIRECTORY[] = ".afterglow";
 const char PROJECT_SESSION_FILE[] = "session.json";
+const char PROJECT_OUTPUT_LOG_FILE[] = "output.log";
+const char PROJECT_METADATA_FILE[] = "metadata.json";
+const char PROJECT_TIMINGS_FILE[] = "timings.json";
+const char PROJECT_PERF_DATA_FILE[] = "perf.data";
+const char PROJECT_CODEGEN_FILE[] = "codegen.json";
+const char PROJECT_RUN_FILE[] = "run.json";
 const char PROJECT_PROPERTIES_FILE[] = "properties.json";
 
 const int MAX_RECENT_FILES = 10;
 const int SEPARATOR_AND_MENU_CLEAR_COUNT = 2;
+// Milliseconds between checks for tabs to hibernate.
+const int HIBERNATE_INTERVAL = 60 * 1000;
 
 // Font Awesome
 const char ICON_COG[] = "\uf013";
@@ -0,0 +1,434 @@
+#include "FileIndex.h"
+#include "Trace.h"
+#include <QtCore>
+#include <algorithm>
+
+// inotify watches are a per-user resource, large trees are only indexed.
+static const int MAX_WATCHED_DIRECTORIES = 8192;
+
+// Directories are taken from a shared queue by all workers, so a single
+// deep subtree doesn't leave the other threads idle.
+struct FileIndex::Walk {
+    QString rootPath;
+    IgnoreMatcher matcher;
+    QMutex mutex;
+    QWaitCondition condition;
+    QStringList queue;
+    int busy = 0;
+    int workers = 0;
+    bool canceled = false;
+    QStringList directories;
+    QStringList files;
+};
+
+class WalkWorker : public QRunnable {
+public:
+    WalkWorker(QSharedPointer<FileIndex::Walk> walk, FileIndex* index, int generation) :
+            walk(walk),
+            index(index),
+            generation(generation) {
+    }
+
+    void run() override {
+        TRACE_SCOPE("FileIndex::walk");
+        QStringList directories;
+        QStringList files;
+
+        forever {
+            QMutexLocker locker(&walk->mutex);
+            while (walk->queue.isEmpty() && walk->busy > 0 && !walk->canceled) {
+                walk->condition.wait(&walk->mutex);
+            }
+
+            if (walk->queue.isEmpty() || walk->canceled) {
+                walk->condition.wakeAll();
+                break;
+            }
+
+            QString relativePath = walk->queue.takeLast();
+            walk->busy++;
+            locker.unlock();
+
+            directories.clear();
+            files.clear();
+            list(relativePath, directories, files);
+
+            locker.relock();
+            walk->queue.append(directories);
+            walk->directories.append(directories);
+            walk->files.append(files);
+            walk->busy--;
+            walk->condition.wakeAll();
+        }
+
+        QMutexLocker locker(&walk->mutex);
+        if (--walk->workers == 0 && !walk->canceled) {
+            emit index->walkFinished(generation, walk->directories, walk->files);
+        }
+    }
+
+private:
+    void list(const QString& relativePath, QStringList& directories, QStringList& files) {
+        QString prefix = relativePath.isEmpty() ? QString() : relativePath + "/";
+        QDirIterator it(walk->rootPath + "/" + relativePath, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot);
+
+        while (it.hasNext()) {
+            it.next();
+            QFileInfo fi = it.fileInfo();
+            QString path = prefix + fi.fileName();
+            bool isDir = fi.isDir();
+
+            // Symbolic links to directories could lead into cycles.
+            if ((isDir && fi.isSymLink()) || walk->matcher.isExcluded(path, isDir)) continue;
+
+            if (isDir) {
+                directories.append(path);
+            } else {
+                files.append(path);
+            }
+        }
+    }
+
+    QSharedPointer<FileIndex::Walk> walk;
+    FileIndex* index;
+    int generation;
+};
+
+FileIndex::FileIndex(QObject* parent) : QObject(parent) {
+    pool = new QThreadPool(this);
+    connect(this, &FileIndex::walkFinished, this, &FileIndex::onWalkFinished, Qt::QueuedConnection);
+
+    watcher = new QFileSystemWatcher(this);
+    connect(watcher, &QFileSystemWatcher::directoryChanged, this, &FileIndex::onDirectoryChanged);
+}
+
+FileIndex::~FileIndex() {
+    cancelWalk();
+    pool->waitForDone();
+}
+
+void FileIndex::setRootPath(const QString& path, const IgnoreMatcher& matcher) {
+    cancelWalk();
+    generation++;
+    ready = false;
+    entries.clear();
+    entryIds.clear();
+    children.clear();
+
+    if (!watcher->directories().isEmpty()) {
+        watcher->removePaths(watcher->directories());
+    }
+
+    rootPath = QDir::cleanPath(QDir::fromNativeSeparators(path));
+    this->matcher = matcher;
+
+    emit updated();
+
+    if (path.isEmpty()) return;
+
+    walk.reset(new Walk);
+    walk->rootPath = rootPath;
+    walk->matcher = matcher;
+    walk->queue.append(QString());
+    walk->workers = pool->maxThreadCount();
+
+    for (int i = 0; i < walk->workers; i++) {
+        pool->start(new WalkWorker(walk, this, generation));
+    }
+}
+
+void FileIndex::cancelWalk() {
+    if (walk.isNull()) return;
+
+    QMutexLocker locker(&walk->mutex);
+    walk->canceled = true;
+    walk->condition.wakeAll();
+    locker.unlock();
+
+    walk.reset();
+}
+
+QStringList FileIndex::match(const QString& pattern, int limit) const {
+    TRACE_SCOPE("FileIndex::match");
+    QByteArray query = pattern.toLower().remove(' ').toUtf8();
+    quint64 queryMask = charMask(query);
+
+    QVector<QPair<int, int>> results;
+
+    for (int i = 0; i < entries.count(); i++) {
+        const Entry& entry = entries.at(i);
+        // All characters of the query must occur somewhere in the path.
+        if ((queryMask & entry.mask) != queryMask) continue;
+
+        int entryScore = query.isEmpty() ? 0 : score(entry, query);
+        if (entryScore != -1) {
+            results.append(qMakePair(entryScore, i));
+        }
+    }
+
+    auto better = [this] (const QPair<int, int>& a, const QPair<int, int>& b) {
+        if (a.first != b.first) return a.first > b.first;
+
+        const QString& pathA = entries.at(a.second).path;
+        const QString& pathB = entries.at(b.second).path;
+        if (pathA.size() != pathB.size()) return pathA.size() < pathB.size();
+
+        return pathA < pathB;
+    };
+
+    int count = qMin(limit, results.count());
+    std::partial_sort(results.begin(), results.begin() + count, results.end(), better);
+
+    QStringList paths;
+    for (int i = 0; i < count; i++) {
+        paths.append(entries.at(results.at(i).second).path);
+    }
+
+    return paths;
+}
+
+void FileIndex::onWalkFinished(int generation, const QStringList& directories, const QStringList& files) {
+    if (generation != this->generation) return;
+
+    TRACE_SCOPE("FileIndex::onWalkFinished");
+    walk.reset();
+
+    entries.reserve(files.count());
+
+    addDirectory(QString());
+    for (const QString& directory : directories) {
+        addDirectory(directory);
+    }
+
+    for (const QString& file : files) {
+        addFile(file);
+    }
+
+    ready = true;
+
+    QStringList watchPaths;
+    watchPaths.append(rootPath);
+    for (const QString& directory : directories) {
+        if (watchPaths.count() == MAX_WATCHED_DIRECTORIES) {
+            qWarning() << "Only" << MAX_WATCHED_DIRECTORIES << "directories of" << rootPath << "are watched for changes";
+            break;
+        }
+        watchPaths.append(rootPath + "/" + directory);
+    }
+    watcher->addPaths(watchPaths);
+
+    emit updated();
+}
+
+void FileIndex::onDirectoryChanged(const QString& path) {
+    if (!ready) return;
+
+    QString relativePath = toRelativePath(path);
+    if (relativePath.isNull() || !children.contains(relativePath)) return;
+
+    if (QFileInfo(path).isDir()) {
+        scanDirectory(relativePath, false);
+    } else {
+        removeDirectory(relativePath);
+    }
+}
+
+void FileIndex::scanDirectory(const QString& relativePath, bool recursive) {
+    QString prefix = relativePath.isEmpty() ? QString() : relativePath + "/";
+    QSet<QString> names;
+
+    QDirIterator it(rootPath + "/" + relativePath, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot);
+    while (it.hasNext()) {
+        it.next();
+        QFileInfo fi = it.fileInfo();
+        QString path = prefix + fi.fileName();
+        bool isDir = fi.isDir();
+
+        if ((isDir && fi.isSymLink()) || matcher.isExcluded(path, isDir)) continue;
+
+        names.insert(fi.fileName());
+
+        if (isDir) {
+            if (!children.contains(path)) {
+                addDirectory(path);
+                if (watcher->directories().count() < MAX_WATCHED_DIRECTORIES) {
+                    watcher->addPath(rootPath + "/" + path);
+                }
+                scanDirectory(path, true);
+            } else if (recursive) {
+                scanDirectory(path, true);
+            }
+        } else if (!entryIds.contains(path)) {
+            addFile(path);
+        }
+    }
+
+    // Entries that are gone, a renamed entry shows up as a removal and an addition.
+    const QSet<QString> known = children.value(relativePath);
+    for (const QString& name : known) {
+        if (names.contains(name)) continue;
+
+        QString path = prefix + name;
+        if (children.contains(path)) {
+            removeDirectory(path);
+        } else {
+            removeFile(path);
+        }
+    }
+}
+
+void FileIndex::addDirectory(const QString& relativePath) {
+    children.insert(relativePath, QSet<QString>());
+
+    if (!relativePath.isEmpty()) {
+        int separator = relativePath.lastIndexOf('/');
+        children[separator == -1 ? QString("") : relativePath.left(separator)].insert(relativePath.mid(separator + 1));
+    }
+}
+
+void FileIndex::addFile(const QString& relativePath) {
+    int separator = relativePath.lastIndexOf('/');
+    children[separator == -1 ? QString("") : relativePath.left(separator)].insert(relativePath.mid(separator + 1));
+
+    Entry entry;
+    entry.path = relativePath;
+    entry.folded = relativePath.toLower().toUtf8();
+    entry.mask = charMask(entry.folded);
+    entry.nameStart = entry.folded.lastIndexOf('/') + 1;
+
+    entryIds.insert(relativePath, entries.count());
+    entries.append(entry);
+}
+
+void FileIndex::removeFile(const QString& relativePath) {
+    int separator = relativePath.lastIndexOf('/');
+    children[separator == -1 ? QString("") : relativePath.left(separator)].remove(relativePath.mid(separator + 1));
+
+    auto it = entryIds.find(relativePath);
+    if (it == entryIds.end()) return;
+
+    // The last entry takes the place of the removed one.
+    int index = it.value();
+    entryIds.erase(it);
+
+    if (index != entries.count() - 1) {
+        entries[index] = entries.last();
+        entryIds[entries.at(index).path] = index;
+    }
+
+    entries.removeLast();
+}
+
+void FileIndex::removeDirectory(const QString& relativePath) {
+    QString prefix = relativePath.isEmpty() ? QString() : relativePath + "/";
+    const QSet<QString> names = children.take(relativePath);
+    for (const QString& name : names) {
+        QString path = prefix + name;
+        if (children.contains(path)) {
+            removeDirectory(path);
+        } else {
+            removeFile(path);
+        }
+    }
+
+    if (!relativePath.isEmpty()) {
+        int separator = relativePath.lastIndexOf('/');
+        children[separator == -1 ? QString("") : relativePath.left(separator)].remove(relativePath.mid(separator + 1));
+    }
+
+    watcher->removePath(rootPath + "/" + relativePath);
+}
+
+QString FileIndex::toRelativePath(const QString& path) const {
+    QString cleanPath = QDir::cleanPath(path);
+    if (cleanPath == rootPath) return QString("");
+    if (!cleanPath.startsWith(rootPath + "/")) return QString();
+
+    return cleanPath.mid(rootPath.size() + 1);
+}
+
+quint64 FileIndex::charMask(const QByteArray& text) {
+    // Letters, digits and a few separators get a bit each, everything else shares one.
+    quint64 mask = 0;
+    for (char c : text) {
+        int bit;
+        if (c >= 'a' && c <= 'z') {
+            bit = c - 'a';
+        } else if (c >= '0' && c <= '9') {
+            bit = 26 + c - '0';
+        } else if (c == '_') {
+            bit = 36;
+        } else if (c == '-') {
+            bit = 37;
+        } else if (c == '.') {
+            bit = 38;
+        } else if (c == '/') {
+            bit = 39;
+        } else {
+            bit = 40;
+        }
+        mask |= Q_UINT64_C(1) << bit;
+    }
+
+    return mask;
+}
+
+int FileIndex::score(const Entry& entry, const QByteArray& query) {
+    const char* text = entry.folded.constData();
+    int length = entry.folded.size();
+    int queryLength = query.size();
+
+    // Find the end of the first match, then walk back to the shortest
+    // window ending there, which prefers compact matches.
+    int q = 0;
+    int end = -1;
+    for (int i = 0; i < length; i++) {
+        if (text[i] == query.at(q) && ++q == queryLength) {
+            end = i;
+            break;
+        }
+    }
+
+    if (end == -1) return -1;
+
+    int start = end;
+    q = queryLength - 1;
+    for (int i = end; i >= 0; i--) {
+        if (text[i] == query.at(q) && --q < 0) {
+            start = i;
+            break;
+        }
+    }
+
+    int result = 0;
+    int previous = -2;
+    q = 0;
+
+    for (int i = start; i <= end && q < queryLength; i++) {
+        if (text[i] != query.at(q)) continue;
+
+        int points = 16;
+        if (i == previous + 1) {
+            points += 24;
+        }
+
+        char before = i > 0 ? text[i - 1] : '/';
+        if (before == '/' || before == '_' || before == '-' || before == '.' || before == ' ') {
+            points += 32;
+        }
+
+        if (i >= entry.nameStart) {
+            points += 16;
+        }
+
+        result += points;
+        previous = i;
+        q++;
+    }
+
+    // Gaps inside the match and long paths cost a little.
+    result -= (end - start + 1 - queryLength);
+    result -= length / 16;
+
+    return qMax(0, result);
+}
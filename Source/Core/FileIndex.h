@@ -0,0 +1,77 @@
+#pragma once
+#include "IgnoreMatcher.h"
+#include <QObject>
+#include <QVector>
+#include <QHash>
+#include <QSet>
+#include <QSharedPointer>
+
+class QFileSystemWatcher;
+class QThreadPool;
+class WalkWorker;
+
+// Relative paths of all files of a project, for quick open. The project is walked
+// on a thread pool when the root is set, afterwards directory change events
+// update only the directories they are about. Ignore rules apply to both.
+class FileIndex : public QObject {
+    Q_OBJECT
+public:
+    explicit FileIndex(QObject* parent = nullptr);
+    ~FileIndex();
+
+    // An empty path clears the index.
+    void setRootPath(const QString& path, const IgnoreMatcher& matcher);
+    QString getRootPath() const { return rootPath; }
+
+    bool isReady() const { return ready; }
+    int getFileCount() const { return entries.count(); }
+
+    // Relative paths fuzzy matching the pattern, best first.
+    QStringList match(const QString& pattern, int limit) const;
+
+signals:
+    void updated();
+    // Delivers the result of a walk from the pool to the index's thread.
+    void walkFinished(int generation, const QStringList& directories, const QStringList& files);
+
+private:
+    friend class WalkWorker;
+
+    struct Entry {
+        QString path;
+        // Lower case UTF-8, matched byte by byte.
+        QByteArray folded;
+        // One bit per character class present, see charMask().
+        quint64 mask;
+        int nameStart;
+    };
+
+    struct Walk;
+
+    void cancelWalk();
+    void onWalkFinished(int generation, const QStringList& directories, const QStringList& files);
+    void onDirectoryChanged(const QString& path);
+    void scanDirectory(const QString& relativePath, bool recursive);
+    void addDirectory(const QString& relativePath);
+    void addFile(const QString& relativePath);
+    void removeFile(const QString& relativePath);
+    void removeDirectory(const QString& relativePath);
+    QString toRelativePath(const QString& path) const;
+
+    static quint64 charMask(const QByteArray& text);
+    static int score(const Entry& entry, const QByteArray& query);
+
+    QString rootPath;
+    IgnoreMatcher matcher;
+    bool ready = false;
+    int generation = 0;
+
+    QVector<Entry> entries;
+    QHash<QString, int> entryIds;
+    // Names of the files and directories in each directory, "" is the root.
+    QHash<QString, QSet<QString>> children;
+
+    QThreadPool* pool;
+    QSharedPointer<Walk> walk;
+    QFileSystemWatcher* watcher;
+};
@@ -0,0 +1,117 @@
+#include "FileOperation.h"
+#include <QtCore>
+#include <functional>
+
+// Progress is reported in steps, not for every entry.
+static const int PROGRESS_STEP = 64;
+
+class FileOperationRunner : public QRunnable {
+public:
+    explicit FileOperationRunner(std::function<void()> function) : function(function) {
+    }
+
+    void run() override {
+        function();
+    }
+
+private:
+    std::function<void()> function;
+};
+
+FileOperation::FileOperation(const QString& path) :
+        path(path),
+        canceled(0) {
+}
+
+FileOperation* FileOperation::remove(const QString& path) {
+    return new FileOperation(path);
+}
+
+void FileOperation::start() {
+    // Signals are emitted from the pool and queued to the thread of this object.
+    QThreadPool::globalInstance()->start(new FileOperationRunner([this] {
+        run();
+    }));
+}
+
+void FileOperation::cancel() {
+    canceled.storeRelease(1);
+}
+
+void FileOperation::run() {
+    bool success = false;
+
+    QFileInfo fi(path);
+    if (fi.isDir() && !fi.isSymLink()) {
+        success = removeRecursively();
+    } else {
+        success = QFile::remove(path);
+    }
+
+    if (!success && !canceled.loadAcquire()) {
+        qWarning() << "Failed to remove" << path;
+    }
+
+    emit finished(success);
+    deleteLater();
+}
+
+bool FileOperation::removeRecursively() {
+    QStringList files;
+    QStringList directories;
+
+    // Links are removed, not followed.
+    QDirIterator it(path, QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        if (canceled.loadAcquire()) return false;
+
+        it.next();
+        QFileInfo fi = it.fileInfo();
+        if (fi.isDir() && !fi.isSymLink()) {
+            directories.append(it.filePath());
+        } else {
+            files.append(it.filePath());
+        }
+    }
+
+    int total = files.count() + directories.count() + 1;
+    int done = 0;
+    bool success = true;
+    emit progress(done, total);
+
+    for (const QString& filePath : files) {
+        if (canceled.loadAcquire()) return false;
+
+        if (!QFile::remove(filePath)) {
+            // Read-only files can't be removed on Windows.
+            QFile file(filePath);
+            if (!file.setPermissions(file.permissions() | QFile::WriteOwner) || !file.remove()) {
+                success = false;
+            }
+        }
+
+        if (++done % PROGRESS_STEP == 0) {
+            emit progress(done, total);
+        }
+    }
+
+    // Children come after their parents in the list.
+    for (int i = directories.count() - 1; i >= 0; i--) {
+        if (canceled.loadAcquire()) return false;
+
+        if (!QDir().rmdir(directories.at(i))) {
+            success = false;
+        }
+
+        if (++done % PROGRESS_STEP == 0) {
+            emit progress(done, total);
+        }
+    }
+
+    if (!QDir().rmdir(path)) {
+        success = false;
+    }
+
+    emit progress(total, total);
+    return success;
+}
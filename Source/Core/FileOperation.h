@@ -0,0 +1,31 @@
+#pragma once
+#include <QObject>
+#include <QAtomicInt>
+
+// Removes a file or directory on the global thread pool, so removing a target
+// directory doesn't freeze the window. Deletes itself when finished, so it has
+// no parent that could delete it while the pool still runs it.
+class FileOperation : public QObject {
+    Q_OBJECT
+public:
+    static FileOperation* remove(const QString& path);
+
+    QString getPath() const { return path; }
+
+    void start();
+    // Stops between entries, what is removed by then stays removed.
+    void cancel();
+
+signals:
+    void progress(int done, int total);
+    void finished(bool success);
+
+private:
+    explicit FileOperation(const QString& path);
+
+    void run();
+    bool removeRecursively();
+
+    QString path;
+    QAtomicInt canceled;
+};
@@ -1,9 +1,64 @@
 #include "Global.h"
 #include "Constants.h"
 #include "Settings.h"
+#include "Preferences.h"
 #include <QtCore>
 
 QString Global::getWorkspacePath() {
     QString workspace = Settings::getValue("workspace").toString();
     return workspace.isEmpty() ? QDir::homePath() + "/" + Constants::WORKSPACE_DIRECTORY : workspace;
 }
+
+QString Global::getCargoPath() {
+    QString cargoPath = Preferences::getInstance()->getCargo().path;
+    return cargoPath.isEmpty() ? "cargo" : cargoPath;
+}
+
+QString Global::getSourcesStamp(const QStringList& packagePaths) {
+    // Only file metadata is read, of all files as include_str! and build scripts
+    // may read any of them. Hidden entries and target directories, including
+    // those of nested workspace members, are skipped. Call off the GUI thread.
+    QStringList paths;
+    QStringList dirs;
+
+    // Members inside the workspace root are walked with it.
+    for (const QString& packagePath : packagePaths) {
+        QString cleanPath = QDir::cleanPath(packagePath);
+        bool nested = false;
+        for (const QString& other : packagePaths) {
+            if (cleanPath.startsWith(QDir::cleanPath(other) + "/")) {
+                nested = true;
+                break;
+            }
+        }
+
+        if (!nested && !dirs.contains(cleanPath)) {
+            dirs << cleanPath;
+        }
+    }
+
+    while (!dirs.isEmpty()) {
+        QDir dir(dirs.takeLast());
+        for (const QFileInfo& fi : dir.entryInfoList(QDir::AllEntries | QDir::NoDotAndDotDot)) {
+            if (fi.isDir()) {
+                if (fi.fileName() != "target") {
+                    dirs.append(fi.filePath());
+                }
+            } else {
+                paths.append(fi.filePath());
+            }
+        }
+    }
+
+    paths.sort();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    for (const QString& path : paths) {
+        QFileInfo fi(path);
+        hash.addData(path.toUtf8());
+        hash.addData(QByteArray::number(fi.lastModified().toMSecsSinceEpoch()));
+        hash.addData(QByteArray::number(fi.size()));
+    }
+
+    return hash.result().toHex();
+}
@@ -9,4 +9,8 @@ public:
     Global(QObject* parent = nullptr);
 
     static QString getWorkspacePath();
+    static QString getCargoPath();
+    // Hash of paths, sizes and modification times of everything under the package
+    // directories, which is everything that affects a build of local packages.
+    static QString getSourcesStamp(const QStringList& packagePaths);
 };
@@ -0,0 +1,146 @@
+#include "IgnoreMatcher.h"
+#include "Settings.h"
+#include <QtCore>
+
+IgnoreMatcher IgnoreMatcher::forProject(const QString& projectPath) {
+    IgnoreMatcher matcher;
+    for (const QJsonValue& pattern : Settings::getValue("gui.projectTree.exclude").toArray()) {
+        matcher.addPattern(pattern.toString());
+    }
+
+    if (Settings::getValue("gui.projectTree.useGitignore").toBool()) {
+        matcher.addPatternsFromFile(projectPath + "/.gitignore");
+    }
+
+    return matcher;
+}
+
+void IgnoreMatcher::clear() {
+    rules.clear();
+}
+
+void IgnoreMatcher::addPattern(const QString& pattern) {
+    QString glob = pattern;
+
+    // Trailing spaces are ignored unless escaped, comments start with #.
+    while (glob.endsWith(' ') && !glob.endsWith("\\ ")) {
+        glob.chop(1);
+    }
+
+    if (glob.isEmpty() || glob.startsWith('#')) return;
+
+    Rule rule;
+
+    if (glob.startsWith('!')) {
+        rule.negated = true;
+        glob.remove(0, 1);
+    } else if (glob.startsWith("\\!") || glob.startsWith("\\#")) {
+        glob.remove(0, 1);
+    }
+
+    if (glob.endsWith('/')) {
+        rule.directoryOnly = true;
+        glob.chop(1);
+    }
+
+    // A slash anywhere but at the end ties the pattern to the root.
+    if (glob.contains('/')) {
+        rule.anchored = true;
+        if (glob.startsWith('/')) {
+            glob.remove(0, 1);
+        }
+    }
+
+    if (glob.isEmpty()) return;
+
+    rule.regExp.setPattern("^" + toRegExp(glob) + "$");
+    rule.regExp.optimize();
+    if (!rule.regExp.isValid()) {
+        qWarning() << "Invalid exclude pattern" << pattern;
+        return;
+    }
+
+    rules.append(rule);
+}
+
+void IgnoreMatcher::addPatterns(const QStringList& patterns) {
+    for (const QString& pattern : patterns) {
+        addPattern(pattern);
+    }
+}
+
+void IgnoreMatcher::addPatternsFromFile(const QString& filePath) {
+    QFile file(filePath);
+    if (!file.exists()) return;
+
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "Failed to open file" << filePath;
+        return;
+    }
+
+    while (!file.atEnd()) {
+        QString line = QString::fromUtf8(file.readLine());
+        line.chop(line.endsWith('\n') ? 1 : 0);
+        addPattern(line);
+    }
+}
+
+bool IgnoreMatcher::isExcluded(const QString& relativePath, bool isDir) const {
+    if (rules.isEmpty() || relativePath.isEmpty()) return false;
+
+    QString name = relativePath.mid(relativePath.lastIndexOf('/') + 1);
+
+    for (int i = rules.count() - 1; i >= 0; i--) {
+        const Rule& rule = rules.at(i);
+        if (rule.directoryOnly && !isDir) continue;
+
+        if (rule.regExp.match(rule.anchored ? relativePath : name).hasMatch()) {
+            return !rule.negated;
+        }
+    }
+
+    return false;
+}
+
+QString IgnoreMatcher::toRegExp(const QString& glob) {
+    QString result;
+
+    for (int i = 0; i < glob.size(); i++) {
+        QChar c = glob.at(i);
+
+        if (c == '*') {
+            if (i + 1 < glob.size() && glob.at(i + 1) == '*') {
+                i++;
+                // "**/" also matches no directory at all.
+                if (i + 1 < glob.size() && glob.at(i + 1) == '/') {
+                    i++;
+                    result += "(?:.*/)?";
+                } else {
+                    result += ".*";
+                }
+            } else {
+                result += "[^/]*";
+            }
+        } else if (c == '?') {
+            result += "[^/]";
+        } else if (c == '[') {
+            int end = glob.indexOf(']', i + 1);
+            if (end == -1) {
+                result += "\\[";
+            } else {
+                QString set = glob.mid(i + 1, end - i - 1);
+                if (set.startsWith('!')) {
+                    set[0] = '^';
+                }
+                result += "[" + set + "]";
+                i = end;
+            }
+        } else if (c == '\\' && i + 1 < glob.size()) {
+            result += QRegularExpression::escape(glob.at(++i));
+        } else {
+            result += QRegularExpression::escape(c);
+        }
+    }
+
+    return result;
+}
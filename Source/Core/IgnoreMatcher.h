@@ -0,0 +1,38 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QRegularExpression>
+
+// Decides whether a project path is excluded, by patterns in .gitignore syntax:
+// "target/" matches a directory at any depth, "/docs" only at the root,
+// "!keep.rs" re-includes, "**" spans directories. The last matching pattern wins.
+class IgnoreMatcher {
+public:
+    // Patterns from gui.projectTree.exclude and, if enabled, the project's .gitignore.
+    static IgnoreMatcher forProject(const QString& projectPath);
+
+    void clear();
+    void addPattern(const QString& pattern);
+    void addPatterns(const QStringList& patterns);
+    // Reads patterns from a .gitignore file, missing files are ignored.
+    void addPatternsFromFile(const QString& filePath);
+
+    bool isEmpty() const { return rules.isEmpty(); }
+
+    // Path relative to the project root, with forward slashes.
+    bool isExcluded(const QString& relativePath, bool isDir) const;
+
+private:
+    struct Rule {
+        QRegularExpression regExp;
+        bool negated = false;
+        bool directoryOnly = false;
+        // Matched against the whole relative path, otherwise against the name only.
+        bool anchored = false;
+    };
+
+    static QString toRegExp(const QString& glob);
+
+    QVector<Rule> rules;
+};
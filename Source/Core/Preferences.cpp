@@ -0,0 +1,59 @@
+#include "Preferences.h"
+#include "Settings.h"
+#include <QtCore>
+
+Preferences::Preferences(QObject* parent) : QObject(parent) {
+    reload();
+}
+
+void Preferences::reload() {
+    if (readGroup("editor", editorJson)) {
+        editor.fontFamily = Settings::getValue("editor.font.family").toString();
+        editor.fontSize = Settings::getValue("editor.font.size").toInt();
+        editor.indent = qMax(1, Settings::getValue("editor.indent").toInt());
+        editor.numberAreaDigits = Settings::getValue("editor.numberAreaDigits").toInt();
+        editor.cleanTrailingWhitespaceOnSave = Settings::getValue("editor.cleanTrailingWhitespaceOnSave").toBool();
+        editor.hibernateIdleMinutes = qMax(0, Settings::getValue("editor.hibernate.idleMinutes").toInt());
+        editor.hibernateMemoryBudget = qMax(0, Settings::getValue("editor.hibernate.memoryBudget").toInt());
+        emit editorChanged();
+    }
+
+    if (readGroup("gui.output", outputJson)) {
+        output.maxLines = qMax(0, Settings::getValue("gui.output.maxLines").toInt());
+        output.logToFile = Settings::getValue("gui.output.logToFile").toBool();
+        emit outputChanged();
+    }
+
+    if (readGroup("cargo", cargoJson)) {
+        cargo.path = Settings::getValue("cargo.path").toString();
+        cargo.checkOnSave = Settings::getValue("cargo.checkOnSave").toBool();
+        cargo.watchCommand = Settings::getValue("cargo.watch.command").toString();
+        cargo.watchDelay = qMax(50, Settings::getValue("cargo.watch.delay").toInt());
+        emit cargoChanged();
+    }
+
+    if (readGroup("test", testJson)) {
+        test.shards = Settings::getValue("test.shards").toInt();
+        test.jsonFormat = Settings::getValue("test.jsonFormat").toBool();
+        emit testChanged();
+    }
+
+    if (readGroup("profile", profileJson)) {
+        profile.frequency = Settings::getValue("profile.frequency").toInt();
+        profile.callGraph = Settings::getValue("profile.callGraph").toString();
+        emit profileChanged();
+    }
+
+    if (readGroup("process", processJson)) {
+        process.maxJobs = Settings::getValue("process.maxJobs").toInt();
+        emit processChanged();
+    }
+}
+
+bool Preferences::readGroup(const QString& path, QJsonValue& last) {
+    QJsonValue value = Settings::getValue(path);
+    if (value == last) return false;
+
+    last = value;
+    return true;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include "Singleton.h"
+#include <QObject>
+#include <QJsonValue>
+
+// Typed settings for code that reads them often, e.g. on every resize of an
+// editor. Values are resolved from Settings once and on reload(), which also
+// notifies subscribers about the groups that changed.
+class Preferences : public QObject, public Singleton<Preferences> {
+    Q_OBJECT
+public:
+    struct Editor {
+        QString fontFamily;
+        int fontSize = 10;
+        int indent = 4;
+        int numberAreaDigits = 4;
+        bool cleanTrailingWhitespaceOnSave = true;
+        // Unmodified background tabs drop their text after this time, 0 never.
+        int hibernateIdleMinutes = 15;
+        // Megabytes of text kept in all tabs together, 0 for no limit.
+        int hibernateMemoryBudget = 128;
+    };
+
+    struct Output {
+        int maxLines = 10000;
+        bool logToFile = false;
+    };
+
+    struct Cargo {
+        QString path;
+        bool checkOnSave = true;
+        QString watchCommand;
+        int watchDelay = 300;
+    };
+
+    struct Test {
+        int shards = 0;
+        bool jsonFormat = false;
+    };
+
+    struct Profile {
+        int frequency = 999;
+        QString callGraph;
+    };
+
+    struct Process {
+        int maxJobs = 0;
+    };
+
+    explicit Preferences(QObject* parent = nullptr);
+
+    const Editor& getEditor() const { return editor; }
+    const Output& getOutput() const { return output; }
+    const Cargo& getCargo() const { return cargo; }
+    const Test& getTest() const { return test; }
+    const Profile& getProfile() const { return profile; }
+    const Process& getProcess() const { return process; }
+
+    // Call after Settings were modified.
+    void reload();
+
+signals:
+    void editorChanged();
+    void outputChanged();
+    void cargoChanged();
+    void testChanged();
+    void profileChanged();
+    void processChanged();
+
+private:
+    // Returns whether the group differs from the one read last time.
+    bool readGroup(const QString& path, QJsonValue& last);
+
+    Editor editor;
+    Output output;
+    Cargo cargo;
+    Test test;
+    Profile profile;
+    Process process;
+
+    QJsonValue editorJson;
+    QJsonValue outputJson;
+    QJsonValue cargoJson;
+    QJsonValue testJson;
+    QJsonValue profileJson;
+    QJsonValue processJson;
+};
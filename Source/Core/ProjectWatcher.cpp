@@ -0,0 +1,200 @@
+#include "ProjectWatcher.h"
+#include "Preferences.h"
+#include <QtCore>
+
+static const QStringList SOURCE_DIRECTORIES = { "src", "tests", "benches", "examples" };
+static const QStringList MANIFEST_FILES = { "Cargo.toml", "build.rs" };
+
+ProjectWatcher::ProjectWatcher(QObject* parent) : QObject(parent) {
+    watcher = new QFileSystemWatcher(this);
+    connect(watcher, &QFileSystemWatcher::directoryChanged, this, &ProjectWatcher::onDirectoryChanged);
+    connect(watcher, &QFileSystemWatcher::fileChanged, this, &ProjectWatcher::onFileChanged);
+
+    changeTimer = new QTimer(this);
+    changeTimer->setSingleShot(true);
+    connect(changeTimer, &QTimer::timeout, this, &ProjectWatcher::changed);
+}
+
+void ProjectWatcher::setProjectPath(const QString& path) {
+    if (path == projectPath) return;
+
+    changeTimer->stop();
+
+    if (!watcher->files().isEmpty()) {
+        watcher->removePaths(watcher->files());
+    }
+
+    if (!watcher->directories().isEmpty()) {
+        watcher->removePaths(watcher->directories());
+    }
+
+    watchedFiles.clear();
+    watchedDirectories.clear();
+    projectPath = path;
+
+    if (!projectPath.isEmpty()) {
+        changeTimer->setInterval(Preferences::getInstance()->getCargo().watchDelay);
+        updateRoots();
+        scan();
+    }
+}
+
+void ProjectWatcher::setMetadata(const QJsonObject& metadata) {
+    this->metadata = metadata;
+
+    // A manifest change has already been reported, new targets are only watched.
+    if (!projectPath.isEmpty()) {
+        updateRoots();
+        scan();
+    }
+}
+
+void ProjectWatcher::onDirectoryChanged(const QString& path) {
+    Q_UNUSED(path)
+
+    // Entries were added, removed or renamed. Only a different set of sources
+    // counts as a change, the project directory itself also sees Cargo.lock and target.
+    if (scan()) {
+        changeTimer->start();
+    }
+}
+
+void ProjectWatcher::onFileChanged(const QString& path) {
+    // Editors that save by renaming replace the file, it is watched
+    // again when the directory change for the new one comes in.
+    if (!QFileInfo::exists(path)) {
+        watcher->removePath(path);
+        watchedFiles.remove(path);
+    }
+
+    changeTimer->start();
+}
+
+void ProjectWatcher::updateRoots() {
+    packageDirectories.clear();
+    packageFiles.clear();
+    sourceDirectories.clear();
+
+    QJsonArray packages = metadata["packages"].toArray();
+    if (packages.isEmpty()) {
+        packageDirectories.append(projectPath);
+        for (const QString& name : MANIFEST_FILES) {
+            packageFiles.append(projectPath + "/" + name);
+        }
+
+        for (const QString& name : SOURCE_DIRECTORIES) {
+            sourceDirectories.append(projectPath + "/" + name);
+        }
+
+        return;
+    }
+
+    // A virtual manifest has no package of its own.
+    QString workspaceRoot = QDir::fromNativeSeparators(metadata["workspace_root"].toString());
+    if (!workspaceRoot.isEmpty()) {
+        packageDirectories.append(workspaceRoot);
+        packageFiles.append(workspaceRoot + "/Cargo.toml");
+    }
+
+    for (const QJsonValue& package : packages) {
+        QString manifestPath = QDir::fromNativeSeparators(package.toObject()["manifest_path"].toString());
+        packageDirectories.append(QFileInfo(manifestPath).absolutePath());
+        packageFiles.append(manifestPath);
+
+        for (const QJsonValue& value : package.toObject()["targets"].toArray()) {
+            QJsonObject target = value.toObject();
+            QString srcPath = QDir::fromNativeSeparators(target["src_path"].toString());
+
+            // Build scripts, wherever package.build puts them, sit next to the manifest.
+            if (target["kind"].toArray().contains("custom-build")) {
+                packageFiles.append(srcPath);
+            } else {
+                sourceDirectories.append(QFileInfo(srcPath).absolutePath());
+            }
+        }
+    }
+
+    // Nested directories, e.g. src/bin next to src, are scanned with their parent.
+    sourceDirectories.removeDuplicates();
+    QStringList roots;
+    for (const QString& path : sourceDirectories) {
+        bool nested = false;
+        for (const QString& other : sourceDirectories) {
+            if (path.startsWith(other + "/")) {
+                nested = true;
+                break;
+            }
+        }
+
+        if (!nested) {
+            roots.append(path);
+        }
+    }
+
+    sourceDirectories = roots;
+}
+
+bool ProjectWatcher::scan() {
+    QStringList directories;
+    QStringList files;
+
+    for (const QString& path : packageDirectories) {
+        if (QFileInfo::exists(path)) {
+            directories.append(path);
+        }
+    }
+
+    for (const QString& path : packageFiles) {
+        if (QFileInfo::exists(path)) {
+            files.append(path);
+        }
+    }
+
+    for (const QString& path : sourceDirectories) {
+        if (QFileInfo::exists(path)) {
+            scanDirectory(path, directories, files);
+        }
+    }
+
+    QSet<QString> currentFiles = QSet<QString>::fromList(files);
+    QSet<QString> currentDirectories = QSet<QString>::fromList(directories);
+
+    QStringList addedPaths = (currentFiles - watchedFiles).toList() + (currentDirectories - watchedDirectories).toList();
+    QStringList removedPaths = (watchedFiles - currentFiles).toList() + (watchedDirectories - currentDirectories).toList();
+    bool filesChanged = currentFiles != watchedFiles;
+
+    watchedFiles = currentFiles;
+    watchedDirectories = currentDirectories;
+
+    if (!removedPaths.isEmpty()) {
+        watcher->removePaths(removedPaths);
+    }
+
+    if (!addedPaths.isEmpty()) {
+        QStringList failedPaths = watcher->addPaths(addedPaths);
+        if (!failedPaths.isEmpty()) {
+            qWarning() << "Failed to watch" << failedPaths.count() << "paths, e.g." << failedPaths.first();
+        }
+    }
+
+    return filesChanged;
+}
+
+void ProjectWatcher::scanDirectory(const QString& path, QStringList& directories, QStringList& files) const {
+    directories.append(path);
+
+    QDirIterator it(path, QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot);
+    while (it.hasNext()) {
+        it.next();
+        QFileInfo fi = it.fileInfo();
+
+        if (fi.isDir()) {
+            // Build output never lives among the sources, but nested crates may have their own.
+            if (!fi.isHidden() && fi.fileName() != "target") {
+                scanDirectory(fi.absoluteFilePath(), directories, files);
+            }
+        } else if (fi.suffix() == "rs") {
+            files.append(fi.absoluteFilePath());
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <QObject>
+#include <QSet>
+#include <QJsonObject>
+
+class QFileSystemWatcher;
+class QTimer;
+
+// Watches the sources of a Cargo project: the manifests of all workspace members,
+// their build scripts and the .rs files in the directories of their targets, taken
+// from cargo metadata. Bursts of changes, e.g. Save All or a git checkout,
+// are reported as a single changed() signal.
+class ProjectWatcher : public QObject {
+    Q_OBJECT
+public:
+    explicit ProjectWatcher(QObject* parent = nullptr);
+
+    // An empty path stops watching.
+    void setProjectPath(const QString& path);
+    QString getProjectPath() const { return projectPath; }
+    // Until it is set, the conventional layout of a single package is watched.
+    void setMetadata(const QJsonObject& metadata);
+
+signals:
+    void changed();
+
+private slots:
+    void onDirectoryChanged(const QString& path);
+    void onFileChanged(const QString& path);
+
+private:
+    void updateRoots();
+    // Returns whether the set of watched files changed.
+    bool scan();
+    void scanDirectory(const QString& path, QStringList& directories, QStringList& files) const;
+
+    QFileSystemWatcher* watcher;
+    QTimer* changeTimer;
+    QString projectPath;
+    QJsonObject metadata;
+    // Package directories are watched for new entries only, source directories recursively.
+    QStringList packageDirectories;
+    QStringList packageFiles;
+    QStringList sourceDirectories;
+    QSet<QString> watchedFiles;
+    QSet<QString> watchedDirectories;
+};
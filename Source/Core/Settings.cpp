@@ -1,10 +1,44 @@
 #include "Settings.h"
 #include "Constants.h"
+#include "Trace.h"
 #include <QtCore>
 
+// Coalesces changes made in a row, e.g. when the main window saves its state.
+static const int WRITE_DELAY = 1000;
+
 QJsonObject Settings::storage = QJsonObject();
+bool Settings::dirty = false;
+QTimer* Settings::writeTimer = nullptr;
+QThreadPool* Settings::writer = nullptr;
+
+class SettingsWriter : public QRunnable {
+public:
+    SettingsWriter(const QString& filePath, const QJsonObject& storage) :
+            filePath(filePath),
+            storage(storage) {
+    }
+
+    void run() override {
+        // The old file stays in place until the new one is complete.
+        QSaveFile file(filePath);
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+            qWarning() << "Failed to open file" << filePath;
+            return;
+        }
+
+        file.write(QJsonDocument(storage).toJson());
+        if (!file.commit()) {
+            qWarning() << "Failed to write file" << filePath << file.errorString();
+        }
+    }
+
+private:
+    QString filePath;
+    QJsonObject storage;
+};
 
 void Settings::init() {
+    TRACE_SCOPE("Settings::init");
     QFile resPrefsFile(":/Resources/prefs.json");
     if (!resPrefsFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
         qWarning() << "Failed to open file" << resPrefsFile.fileName();
@@ -32,33 +66,45 @@ void Settings::init() {
             qWarning() << "Error:" << err.errorString() << "offset:" << err.offset;
             return;
         }
-        // Update preferences.
+        // Update preferences. The file is only rewritten if that changed anything.
+        QJsonObject loaded = storage;
         QJsonObject src = resDoc.object();
         cleanupDeprecated(src, storage);
         appendNew(src, storage);
+        dirty = storage != loaded;
     } else {
         // Create preferences from resources.
         storage = resDoc.object();
+        dirty = true;
     }
 
-    flush();
+    if (dirty) {
+        write();
+    }
 }
 
 void Settings::flush() {
-    QFile file(QCoreApplication::applicationDirPath() + "/" + Constants::APP_PREFS_NAME);
-    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        qWarning() << "Failed to open file" << file.fileName();
-        return;
+    if (writeTimer) {
+        writeTimer->stop();
+    }
+
+    if (dirty) {
+        write();
     }
 
-    QJsonDocument doc(storage);
-    file.write(doc.toJson());
+    if (writer) {
+        writer->waitForDone();
+    }
 }
 
 // Using:
 // Settings::setValue("window.width", 42);
 void Settings::setValue(const QString& path, const QJsonValue& value) {
+    if (getValue(path) == value) return;
+
     modifyJsonValue(storage, path, value);
+    dirty = true;
+    scheduleWrite();
 }
 
 // Using:
@@ -120,3 +166,30 @@ void Settings::modifyJsonValue(QJsonObject& obj, const QString& path, const QJso
 
     obj[propertyName] = subValue;
 }
+
+void Settings::scheduleWrite() {
+    if (!writeTimer) {
+        writeTimer = new QTimer(QCoreApplication::instance());
+        writeTimer->setSingleShot(true);
+        writeTimer->setInterval(WRITE_DELAY);
+        QObject::connect(writeTimer, &QTimer::timeout, [] {
+            if (dirty) {
+                write();
+            }
+        });
+    }
+
+    writeTimer->start();
+}
+
+void Settings::write() {
+    if (!writer) {
+        // A single thread keeps writes in order.
+        writer = new QThreadPool(QCoreApplication::instance());
+        writer->setMaxThreadCount(1);
+    }
+
+    // The writer gets its own copy, later changes don't touch it.
+    writer->start(new SettingsWriter(QCoreApplication::applicationDirPath() + "/" + Constants::APP_PREFS_NAME, storage));
+    dirty = false;
+}
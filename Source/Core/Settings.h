@@ -1,10 +1,16 @@
 #pragma once
 #include <QJsonValue>
 
+class QTimer;
+class QThreadPool;
+
+// Changes are written back to the preferences file shortly after they are made,
+// on a background thread and atomically, so a crash can't leave a truncated file.
 class Settings {
 
 public:
     static void init();
+    // Writes pending changes and waits until they are on disk.
     static void flush();
 
     static void setValue(const QString& path, const QJsonValue& value);
@@ -14,6 +20,11 @@ private:
     static void cleanupDeprecated(QJsonObject& src, QJsonObject& dst);
     static void appendNew(QJsonObject& src, QJsonObject& dst);
     static void modifyJsonValue(QJsonObject& obj, const QString& path, const QJsonValue& newValue);
+    static void scheduleWrite();
+    static void write();
 
     static QJsonObject storage;
+    static bool dirty;
+    static QTimer* writeTimer;
+    static QThreadPool* writer;
 };
@@ -0,0 +1,93 @@
+#include "Trace.h"
+#include <QtCore>
+
+std::atomic<bool> Trace::enabled(false);
+QString Trace::filePath;
+QElapsedTimer Trace::timer;
+QMutex Trace::mutex;
+QVector<Trace::Event> Trace::events;
+QVector<Qt::HANDLE> Trace::threads;
+
+void Trace::start(const QString& filePath) {
+    Trace::filePath = filePath;
+    events.reserve(1024);
+    timer.start();
+    enabled.store(true, std::memory_order_release);
+}
+
+void Trace::stop() {
+    if (!enabled.exchange(false)) return;
+
+    QMutexLocker locker(&mutex);
+
+    QJsonArray traceEvents;
+    qint64 pid = QCoreApplication::applicationPid();
+
+    for (const Event& event : events) {
+        QJsonObject obj;
+        obj["name"] = QString::fromUtf8(event.name);
+        obj["ts"] = event.start;
+        obj["pid"] = pid;
+        obj["tid"] = event.thread;
+
+        if (event.duration < 0) {
+            obj["ph"] = "i";
+            obj["s"] = "g";
+        } else {
+            obj["ph"] = "X";
+            obj["dur"] = event.duration;
+        }
+
+        traceEvents.append(obj);
+    }
+
+    QJsonObject root;
+    root["traceEvents"] = traceEvents;
+    root["displayTimeUnit"] = "ms";
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        qWarning() << "Failed to open file for writing" << filePath;
+        return;
+    }
+
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+}
+
+void Trace::mark(const char* name) {
+    if (!isEnabled()) return;
+
+    QMutexLocker locker(&mutex);
+    events.append({ name, now(), -1, currentThread() });
+}
+
+qint64 Trace::begin() {
+    return isEnabled() ? now() : -1;
+}
+
+void Trace::end(const char* name, qint64 start) {
+    if (start < 0 || !isEnabled()) return;
+
+    addSpan(name, start, now() - start);
+}
+
+qint64 Trace::now() {
+    return timer.nsecsElapsed() / 1000;
+}
+
+void Trace::addSpan(const char* name, qint64 start, qint64 duration) {
+    QMutexLocker locker(&mutex);
+    events.append({ name, start, duration, currentThread() });
+}
+
+int Trace::currentThread() {
+    // Small numbers read better than native handles in the viewer.
+    Qt::HANDLE handle = QThread::currentThreadId();
+    int index = threads.indexOf(handle);
+    if (index == -1) {
+        index = threads.count();
+        threads.append(handle);
+    }
+
+    return index + 1;
+}
@@ -0,0 +1,71 @@
+#pragma once
+#include <QString>
+#include <QVector>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <atomic>
+
+// Timing of startup phases and editor operations as spans, written as Chrome
+// trace event JSON (chrome://tracing, Perfetto) when started with --trace <file>.
+// Without it a span costs a check of a flag.
+class Trace {
+public:
+    class Scope {
+    public:
+        explicit Scope(const char* name) : name(isEnabled() ? name : nullptr) {
+            if (this->name) {
+                start = now();
+            }
+        }
+
+        ~Scope() {
+            if (name) {
+                addSpan(name, start, now() - start);
+            }
+        }
+
+    private:
+        const char* name;
+        qint64 start = 0;
+    };
+
+    static void start(const QString& filePath);
+    // Writes the collected events.
+    static void stop();
+    // Acquire pairs with start(), so a span sees the started timer.
+    static bool isEnabled() { return enabled.load(std::memory_order_acquire); }
+
+    // A point in time, e.g. the first iteration of the event loop.
+    static void mark(const char* name);
+
+    // Spans of asynchronous phases, e.g. from enqueueing a job to handling its result.
+    // begin() returns the start, -1 if tracing is off, which is passed to end().
+    static qint64 begin();
+    static void end(const char* name, qint64 start);
+
+private:
+    struct Event {
+        const char* name;
+        qint64 start;
+        // -1 for marks.
+        qint64 duration;
+        int thread;
+    };
+
+    // Microseconds since start().
+    static qint64 now();
+    static void addSpan(const char* name, qint64 start, qint64 duration);
+    static int currentThread();
+
+    // Spans check it from any thread.
+    static std::atomic<bool> enabled;
+    static QString filePath;
+    static QElapsedTimer timer;
+    static QMutex mutex;
+    static QVector<Event> events;
+    static QVector<Qt::HANDLE> threads;
+};
+
+#define TRACE_CONCAT_IMPL(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_IMPL(a, b)
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCAT(traceScope, __LINE__)(name)
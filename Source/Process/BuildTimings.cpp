@@ -0,0 +1,184 @@
+#include "BuildTimings.h"
+#include <QtCore>
+
+static const int MAX_HISTORY_ENTRIES = 20;
+
+bool BuildTimings::load(const QString& reportPath) {
+    units.clear();
+    criticalPath.clear();
+    total = 0;
+
+    QFile file(reportPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open timings report for reading" << reportPath;
+        return false;
+    }
+
+    // The report embeds its data as a JavaScript array:
+    // const UNIT_DATA = [ ... ];
+    QByteArray html = file.readAll();
+    const QByteArray prefix = "const UNIT_DATA = ";
+    int begin = html.indexOf(prefix);
+    int end = begin != -1 ? html.indexOf("];", begin) : -1;
+    if (end == -1) {
+        qWarning() << "Failed to find unit data in timings report" << reportPath;
+        return false;
+    }
+
+    begin += prefix.size();
+    QJsonParseError error;
+    QJsonDocument doc = QJsonDocument::fromJson(html.mid(begin, end + 1 - begin), &error);
+    if (error.error != QJsonParseError::NoError) {
+        qWarning() << "Failed to parse timings report" << reportPath << error.errorString();
+        return false;
+    }
+
+    QJsonArray data = doc.array();
+
+    // Units refer to each other by their "i" field.
+    QHash<int, int> indices;
+    for (int i = 0; i < data.count(); i++) {
+        indices[data.at(i).toObject()["i"].toInt()] = i;
+    }
+
+    auto toIndices = [&] (const QJsonArray& array) -> QVector<int> {
+        QVector<int> result;
+        for (const QJsonValue& value : array) {
+            auto it = indices.find(value.toInt());
+            if (it != indices.end()) {
+                result.append(it.value());
+            }
+        }
+
+        return result;
+    };
+
+    QVector<QVector<int>> unlocked;
+    QVector<QVector<int>> unlockedRmeta;
+
+    for (const QJsonValue& value : data) {
+        QJsonObject obj = value.toObject();
+
+        Unit unit;
+        // Target is empty for libraries, otherwise it starts with a space, e.g. " build script".
+        unit.name = QString("%1 v%2%3").arg(obj["name"].toString(), obj["version"].toString(), obj["target"].toString());
+        unit.start = obj["start"].toDouble();
+        unit.duration = obj["duration"].toDouble();
+        if (obj["rmeta_time"].isDouble()) {
+            unit.frontend = obj["rmeta_time"].toDouble();
+        }
+
+        total = qMax(total, unit.start + unit.duration);
+        units.append(unit);
+
+        unlocked.append(toIndices(obj["unlocked_units"].toArray()));
+        unlockedRmeta.append(toIndices(obj["unlocked_rmeta_units"].toArray()));
+    }
+
+    findCriticalPath(unlocked, unlockedRmeta);
+
+    return true;
+}
+
+QVector<BuildTimings::HistoryEntry> BuildTimings::loadHistory(const QString& historyPath) {
+    QVector<HistoryEntry> history;
+
+    QFile file(historyPath);
+    if (!file.exists()) return history;
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open timings history file for reading" << historyPath;
+        return history;
+    }
+
+    for (const QJsonValue& value : QJsonDocument::fromJson(file.readAll()).array()) {
+        QJsonObject obj = value.toObject();
+
+        HistoryEntry entry;
+        entry.date = obj["date"].toString();
+        entry.total = obj["total"].toDouble();
+
+        QJsonObject durations = obj["units"].toObject();
+        for (auto it = durations.constBegin(); it != durations.constEnd(); ++it) {
+            entry.durations[it.key()] = it.value().toDouble();
+        }
+
+        history.append(entry);
+    }
+
+    return history;
+}
+
+void BuildTimings::appendToHistory(const QString& historyPath) const {
+    QJsonArray history;
+
+    QFile historyFile(historyPath);
+    if (historyFile.open(QIODevice::ReadOnly)) {
+        history = QJsonDocument::fromJson(historyFile.readAll()).array();
+        historyFile.close();
+    }
+
+    QJsonObject durations;
+    for (const Unit& unit : units) {
+        durations[unit.name] = unit.duration;
+    }
+
+    QJsonObject entry;
+    entry["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    entry["total"] = total;
+    entry["units"] = durations;
+    history.append(entry);
+
+    while (history.count() > MAX_HISTORY_ENTRIES) {
+        history.removeFirst();
+    }
+
+    QDir().mkpath(QFileInfo(historyPath).absolutePath());
+
+    // A crash while writing must not lose the whole history.
+    QSaveFile file(historyPath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open timings history file for writing" << historyPath;
+        return;
+    }
+
+    file.write(QJsonDocument(history).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qWarning() << "Failed to write timings history file" << historyPath << file.errorString();
+    }
+}
+
+void BuildTimings::findCriticalPath(const QVector<QVector<int>>& unlocked, const QVector<QVector<int>>& unlockedRmeta) {
+    // A unit waits for the dependency that finished last, either completely
+    // or only up to its metadata when pipelining allows it.
+    QVector<int> blockers(units.count(), -1);
+    QVector<double> readyTimes(units.count(), -1);
+
+    auto unlock = [&] (int blocker, const QVector<int>& dependents, double time) {
+        for (int dependent : dependents) {
+            if (time > readyTimes.at(dependent)) {
+                readyTimes[dependent] = time;
+                blockers[dependent] = blocker;
+            }
+        }
+    };
+
+    int last = -1;
+    for (int i = 0; i < units.count(); i++) {
+        const Unit& unit = units.at(i);
+        unlock(i, unlocked.at(i), unit.start + unit.duration);
+        if (unit.frontend >= 0) {
+            unlock(i, unlockedRmeta.at(i), unit.start + unit.frontend);
+        }
+
+        if (last == -1 || unit.start + unit.duration > units.at(last).start + units.at(last).duration) {
+            last = i;
+        }
+    }
+
+    // Walk back from the unit that finished last. The length check guards against malformed data.
+    for (int i = last; i != -1 && criticalPath.count() < units.count(); i = blockers.at(i)) {
+        criticalPath.prepend(i);
+        units[i].critical = true;
+    }
+}
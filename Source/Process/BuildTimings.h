@@ -0,0 +1,40 @@
+#pragma once
+#include <QString>
+#include <QVector>
+#include <QHash>
+
+// Compilation units of the HTML report written by cargo build --timings.
+class BuildTimings {
+public:
+    struct Unit {
+        QString name;
+        double start = 0;
+        double duration = 0;
+        // Time until metadata was produced, -1 if not reported (e.g. build scripts).
+        double frontend = -1;
+        bool critical = false;
+    };
+
+    struct HistoryEntry {
+        QString date;
+        double total = 0;
+        QHash<QString, double> durations;
+    };
+
+    bool load(const QString& reportPath);
+
+    const QVector<Unit>& getUnits() const { return units; }
+    const QVector<int>& getCriticalPath() const { return criticalPath; }
+    double getTotal() const { return total; }
+
+    // Previous runs are kept in the project data directory, newest last.
+    static QVector<HistoryEntry> loadHistory(const QString& historyPath);
+    void appendToHistory(const QString& historyPath) const;
+
+private:
+    void findCriticalPath(const QVector<QVector<int>>& unlocked, const QVector<QVector<int>>& unlockedRmeta);
+
+    QVector<Unit> units;
+    QVector<int> criticalPath;
+    double total = 0;
+};
@@ -0,0 +1,83 @@
+#include "CallTree.h"
+#include <QtCore>
+#include <algorithm>
+
+CallTree::CallTree() {
+    nodes.append(Node());
+}
+
+void CallTree::addStack(const QVector<Frame>& frames, qint64 weight) {
+    int index = ROOT;
+    nodes[index].total += weight;
+
+    for (const Frame& frame : frames) {
+        index = findOrCreateChild(index, intern(frame.name, names, nameIds));
+        nodes[index].total += weight;
+
+        if (nodes.at(index).source == -1 && !frame.source.isEmpty()) {
+            nodes[index].source = intern(frame.source, sources, sourceIds);
+        }
+    }
+
+    nodes[index].self += weight;
+}
+
+void CallTree::sortChildren() {
+    QVector<int> siblings;
+
+    for (Node& node : nodes) {
+        siblings.clear();
+        for (int child = node.firstChild; child != -1; child = nodes.at(child).nextSibling) {
+            siblings.append(child);
+        }
+
+        if (siblings.count() < 2) continue;
+
+        std::sort(siblings.begin(), siblings.end(), [this] (int a, int b) {
+            return names.at(nodes.at(a).name) < names.at(nodes.at(b).name);
+        });
+
+        node.firstChild = siblings.first();
+        for (int i = 0; i < siblings.count(); i++) {
+            nodes[siblings.at(i)].nextSibling = i + 1 < siblings.count() ? siblings.at(i + 1) : -1;
+        }
+    }
+}
+
+QString CallTree::getName(int index) const {
+    int name = nodes.at(index).name;
+    return name == -1 ? QString("all") : names.at(name);
+}
+
+QString CallTree::getSource(int index) const {
+    int source = nodes.at(index).source;
+    return source == -1 ? QString() : sources.at(source);
+}
+
+int CallTree::intern(const QString& string, QStringList& list, QHash<QString, int>& ids) {
+    auto it = ids.find(string);
+    if (it != ids.end()) return it.value();
+
+    list.append(string);
+    ids.insert(string, list.count() - 1);
+    return list.count() - 1;
+}
+
+int CallTree::findOrCreateChild(int parent, int name) {
+    quint64 key = (static_cast<quint64>(parent) << 32) | static_cast<quint32>(name);
+
+    auto it = children.find(key);
+    if (it != children.end()) return it.value();
+
+    Node node;
+    node.name = name;
+    node.parent = parent;
+    node.nextSibling = nodes.at(parent).firstChild;
+    nodes.append(node);
+
+    int index = nodes.count() - 1;
+    nodes[parent].firstChild = index;
+    children.insert(key, index);
+
+    return index;
+}
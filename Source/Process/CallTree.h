@@ -0,0 +1,51 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+
+// Prefix tree of sampled call stacks. Identical stack prefixes share nodes
+// and names are interned, so memory grows with distinct stacks, not samples.
+class CallTree {
+public:
+    struct Frame {
+        QString name;
+        QString source; // file:line, may be empty
+    };
+
+    struct Node {
+        int name = -1;
+        int source = -1;
+        int parent = -1;
+        int firstChild = -1;
+        int nextSibling = -1;
+        qint64 total = 0;
+        qint64 self = 0;
+    };
+
+    CallTree();
+
+    // Frames are ordered from the outermost caller to the sampled function.
+    void addStack(const QVector<Frame>& frames, qint64 weight = 1);
+    // Orders children by name, as flame graphs do.
+    void sortChildren();
+
+    static const int ROOT = 0;
+
+    int getNodeCount() const { return nodes.count(); }
+    const Node& getNode(int index) const { return nodes.at(index); }
+    QString getName(int index) const;
+    QString getSource(int index) const;
+    qint64 getSampleCount() const { return nodes.at(ROOT).total; }
+
+private:
+    int intern(const QString& string, QStringList& list, QHash<QString, int>& ids);
+    int findOrCreateChild(int parent, int name);
+
+    QVector<Node> nodes;
+    QStringList names;
+    QHash<QString, int> nameIds;
+    QStringList sources;
+    QHash<QString, int> sourceIds;
+    QHash<quint64, int> children;
+};
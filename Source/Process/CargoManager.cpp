@@ -1,15 +1,40 @@
 #include "CargoManager.h"
+#include "ProcessJob.h"
 #include "UI/ProjectProperties.h"
-#include "Core/Settings.h"
+#include "Core/Global.h"
+#include "Core/Constants.h"
+#include "Core/Preferences.h"
 #include <QtCore>
 
+class SourcesStampRunner : public QRunnable {
+public:
+    SourcesStampRunner(CargoManager* cargoManager, int request, const QStringList& packagePaths) :
+            cargoManager(cargoManager),
+            request(request),
+            packagePaths(packagePaths) {
+    }
+
+    void run() override {
+        emit cargoManager->sourcesStampReady(request, Global::getSourcesStamp(packagePaths));
+    }
+
+private:
+    CargoManager* cargoManager;
+    int request;
+    QStringList packagePaths;
+};
+
 CargoManager::CargoManager(ProjectProperties* projectProperties, QObject* parent) :
         ProcessManager(parent),
         projectProperties(projectProperties) {
+    stampPool = new QThreadPool(this);
+    stampPool->setMaxThreadCount(1);
+    connect(this, &CargoManager::sourcesStampReady, this, &CargoManager::onSourcesStampReady, Qt::QueuedConnection);
 }
 
 CargoManager::~CargoManager() {
-
+    // Runners emit on this object.
+    stampPool->waitForDone();
 }
 
 void CargoManager::createProject(ProjectTemplate projectTemplate, const QString& path) {
@@ -22,8 +47,7 @@ void CargoManager::createProject(ProjectTemplate projectTemplate, const QString&
     }
 
     arguments << path;
-    commandStatus = CommandStatus::New;
-    prepareAndStart(arguments);
+    prepareAndStart(arguments, CommandStatus::New);
     setProjectPath(path);
 }
 
@@ -33,74 +57,513 @@ void CargoManager::build() {
     if (projectProperties->getBuildTarget() == BuildTarget::Release) {
         arguments << "--release";
     }
-    commandStatus = CommandStatus::Build;
-    prepareAndStart(arguments);
+    prepareAndStart(arguments, CommandStatus::Build);
+}
+
+void CargoManager::buildWithTimings() {
+    QStringList arguments;
+    arguments << "build" << "--timings";
+    if (projectProperties->getBuildTarget() == BuildTarget::Release) {
+        arguments << "--release";
+    }
+    prepareAndStart(arguments, CommandStatus::BuildTimings);
 }
 
 void CargoManager::run() {
+    int request = ++runRequest;
+
+    // Only binaries are built and started directly.
+    QString executable = projectProperties->getRunTarget();
+    QString kind = projectProperties->getRunTargetKind();
+    if (kind != "bin") {
+        runWithCargo(kind, QFileInfo(executable).fileName());
+        return;
+    }
+
+    // The stamp walks the whole project and the local packages it depends on.
+    stampPool->start(new SourcesStampRunner(this, request, projectProperties->getLocalPackagePaths()));
+}
+
+void CargoManager::onSourcesStampReady(int request, const QString& sourcesStamp) {
+    if (request != runRequest) return;
+
+    // Skip cargo entirely when nothing changed since the last build of the executable.
+    QString executable = projectProperties->getRunTarget();
+    if (isRunStampValid(executable, sourcesStamp)) {
+        launch(executable, true);
+        return;
+    }
+
+    // Otherwise build and start the produced executable without cargo run.
+    QStringList arguments;
+    arguments << "build" << "--message-format=json-diagnostic-rendered-ansi";
+    if (projectProperties->getBuildTarget() == BuildTarget::Release) {
+        arguments << "--release";
+    }
+
+    QString target = QFileInfo(executable).fileName();
+    if (!target.isEmpty()) {
+        arguments << "--bin" << target;
+    }
+
+    ProcessJob* job = prepareAndStart(arguments, CommandStatus::Run);
+    commands[job].sourcesStamp = sourcesStamp;
+}
+
+void CargoManager::runWithCargo(const QString& kind, const QString& target) {
     QStringList arguments;
     arguments << "run";
     if (projectProperties->getBuildTarget() == BuildTarget::Release) {
         arguments << "--release";
     }
-    commandStatus = CommandStatus::Run;
+
+    if (kind == "example") {
+        arguments << "--example" << target;
+    }
+
+    QStringList programArguments;
+    for (const QString& argument : projectProperties->getArgumentsList()) {
+        if (!argument.isEmpty()) {
+            programArguments << argument;
+        }
+    }
+
+    if (!programArguments.isEmpty()) {
+        arguments << "--" << programArguments;
+    }
+
     prepareAndStart(arguments);
 }
 
+void CargoManager::bench() {
+    QStringList arguments;
+    arguments << "bench";
+    prepareAndStart(arguments, CommandStatus::Bench);
+}
+
+void CargoManager::emitCode(const QString& emitType) {
+    QStringList arguments;
+    arguments << "rustc" << "--release";
+
+    QString target = projectProperties->getRunTargetName();
+    QString kind = projectProperties->getRunTargetKind();
+    if (kind == "bin" || kind == "example" || kind == "test" || kind == "bench") {
+        arguments << "--" + kind << target;
+    } else if (!target.isEmpty()) {
+        // Libraries of any crate type.
+        arguments << "--lib";
+    }
+
+    QString crate = target.isEmpty() ? projectProperties->getPackageName() : target;
+
+    // Line tables give source correlation, a single codegen unit gives a single file.
+    arguments << "--" << "--emit" << emitType << "-C" << "debuginfo=1" << "-C" << "codegen-units=1";
+
+    ProcessJob* job = prepareAndStart(arguments, CommandStatus::Emit);
+    commands[job].outputSuffix = emitType == "asm" ? "s" : "ll";
+    // Rustc names outputs <crate>-<hash>, deps also holds those of dependencies.
+    commands[job].outputCrate = crate.replace('-', '_');
+    commands[job].outputDirectory = kind == "example" ? "examples" : "deps";
+}
+
 void CargoManager::clean() {
     QStringList arguments;
     arguments << "clean";
     prepareAndStart(arguments);
 }
 
+void CargoManager::check() {
+    cancelCheck();
+
+    QStringList arguments;
+    arguments << "check";
+    arguments << "--message-format=json";
+    if (projectProperties->getBuildTarget() == BuildTarget::Release) {
+        arguments << "--release";
+    }
+
+    checkJob = prepareAndStart(arguments, CommandStatus::Check);
+}
+
+void CargoManager::cancelCheck() {
+    if (checkJob) {
+        // Reset first, canceling a queued job finishes it synchronously.
+        ProcessJob* job = checkJob;
+        checkJob = nullptr;
+        job->cancel();
+    }
+
+    checkBuffer.clear();
+    checkDiagnostics.clear();
+}
+
+void CargoManager::watch() {
+    cancelWatch();
+
+    QStringList arguments = Preferences::getInstance()->getCargo().watchCommand.split(' ', QString::SkipEmptyParts);
+    if (arguments.isEmpty()) {
+        arguments << "check";
+    }
+
+    static const QStringList profileCommands = { "build", "check", "clippy", "run", "test", "bench" };
+    if (projectProperties->getBuildTarget() == BuildTarget::Release && profileCommands.contains(arguments.first())) {
+        arguments.insert(1, "--release");
+    }
+
+    watchJob = prepareAndStart(arguments, CommandStatus::Watch);
+}
+
+void CargoManager::cancelWatch() {
+    if (watchJob) {
+        // Reset first, canceling a queued job finishes it synchronously.
+        ProcessJob* job = watchJob;
+        watchJob = nullptr;
+        job->cancel();
+    }
+}
+
 void CargoManager::setProjectPath(const QString& path) {
     projectPath = path;
-    getProcess()->setWorkingDirectory(path);
+    setWorkingDirectory(path);
 }
 
-void CargoManager::onReadyReadStandardOutput(const QString& data) {
-    emit consoleMessage(data);
+QString CargoManager::getTargetPath() const {
+    // Cargo resolves build.target-dir and the workspace root into the metadata.
+    QString targetDirectory = projectProperties->getTargetDirectory();
+    if (!targetDirectory.isEmpty()) {
+        return targetDirectory;
+    }
+
+    // Until the metadata arrives.
+    QString targetPath = QString::fromLocal8Bit(qgetenv("CARGO_TARGET_DIR"));
+    if (targetPath.isEmpty()) {
+        targetPath = "target";
+    }
+
+    return QDir(projectPath).absoluteFilePath(targetPath);
 }
 
-void CargoManager::onReadyReadStandardError(const QString& data) {
-    emit consoleMessage(data);
+void CargoManager::onStarted(ProcessJob* job) {
+    // Background checks don't write to the console.
+    if (commands.value(job).status == CommandStatus::Check) return;
+
+    // Clear the console only if no other job is writing into it.
+    bool start = commands.value(job).clearConsole;
+    for (ProcessJob* other : getJobs()) {
+        if (other != job && other->getState() == ProcessJob::State::Running
+                && commands.value(other).status != CommandStatus::Check) {
+            start = false;
+            break;
+        }
+    }
+
+    coloredOutputMessage(commands.value(job).title, start);
+}
+
+void CargoManager::onReadyReadStandardOutput(ProcessJob* job, const QString& data) {
+    if (commands.value(job).status == CommandStatus::Run) {
+        QString& buffer = commands[job].buffer;
+        buffer += data;
+
+        int begin = 0;
+        int end = buffer.indexOf('\n');
+        while (end != -1) {
+            QString line = buffer.mid(begin, end - begin);
+            begin = end + 1;
+            end = buffer.indexOf('\n', begin);
+            parseRunMessage(job, line);
+        }
+        commands[job].buffer.remove(0, begin);
+        return;
+    }
+
+    if (commands.value(job).status != CommandStatus::Check) {
+        emit consoleMessage(data);
+        return;
+    }
+
+    if (job != checkJob) return;
+
+    // One JSON message per line, the last one may be incomplete.
+    checkBuffer += data;
+    int begin = 0;
+    int end = checkBuffer.indexOf('\n');
+    while (end != -1) {
+        parseCheckMessage(checkBuffer.mid(begin, end - begin));
+        begin = end + 1;
+        end = checkBuffer.indexOf('\n', begin);
+    }
+    checkBuffer.remove(0, begin);
 }
 
-void CargoManager::onFinished(int exitCode, QProcess::ExitStatus exitStatus) {
-    switch (commandStatus) {
+void CargoManager::onReadyReadStandardError(ProcessJob* job, const QString& data) {
+    if (commands.value(job).status != CommandStatus::Check) {
+        emit consoleMessage(data);
+    }
+}
+
+void CargoManager::onFinished(ProcessJob* job, int exitCode, QProcess::ExitStatus exitStatus) {
+    Command command = commands.take(job);
+
+    if (job == watchJob) {
+        watchJob = nullptr;
+    }
+
+    if (command.status == CommandStatus::Check) {
+        if (job == checkJob) {
+            parseCheckMessage(checkBuffer);
+            emit checkFinished(checkDiagnostics);
+            checkJob = nullptr;
+            checkBuffer.clear();
+            checkDiagnostics.clear();
+        }
+
+        return;
+    }
+
+    QString launchPath;
+
+    switch (command.status) {
         case CommandStatus::New:
-            emit projectCreated(getProcess()->arguments().last());
+            emit projectCreated(job->getArguments().last());
+            break;
+        case CommandStatus::Run:
+            if (!job->isCanceled() && exitStatus == QProcess::NormalExit && exitCode == 0 && !command.executable.isEmpty()) {
+                saveRunStamp(command.executable, command.sourcesStamp);
+                launchPath = command.executable;
+            }
+            break;
+        case CommandStatus::BuildTimings:
+            if (!job->isCanceled() && exitStatus == QProcess::NormalExit && exitCode == 0) {
+                emit timingsReady(getTargetPath() + "/cargo-timings/cargo-timing.html");
+            }
+            break;
+        case CommandStatus::Emit: {
+            QString outputPath;
+            if (!job->isCanceled() && exitStatus == QProcess::NormalExit && exitCode == 0) {
+                QDir outputDir(getTargetPath() + "/release/" + command.outputDirectory);
+                QStringList filters(command.outputCrate + "-*." + command.outputSuffix);
+                QFileInfoList outputs = outputDir.entryInfoList(filters, QDir::Files, QDir::Time);
+                if (!outputs.isEmpty()) {
+                    outputPath = outputs.first().absoluteFilePath();
+                }
+            }
+
+            emit codegenEmitted(outputPath);
+            break;
+        }
+        case CommandStatus::Bench:
+            // Failing benchmarks still leave results of the ones that ran.
+            if (!job->isCanceled()) {
+                emit benchFinished(getTargetPath() + "/criterion");
+            }
             break;
         default:
             break;
     }
 
-    QString message = QString("%1 %2 with code %3")
-            .arg(getProcess()->program())
-            .arg(exitStatus == QProcess::NormalExit ? "finished" : "crashed")
-            .arg(exitCode);
+    QString message;
+    if (job->isCanceled()) {
+        message = QString("%1 canceled").arg(command.title);
+    } else {
+        message = QString("%1 %2 with code %3 (%4 s)")
+                .arg(command.title)
+                .arg(exitStatus == QProcess::NormalExit ? "finished" : "crashed")
+                .arg(exitCode)
+                .arg(job->getElapsed() / 1000.0, 0, 'f', 2);
+    }
+
     coloredOutputMessage(message);
+
+    if (!launchPath.isEmpty()) {
+        launch(launchPath, false);
+    }
 }
 
-void CargoManager::prepareAndStart(const QStringList& arguments) {
-    QString cargoPath = Settings::getValue("cargo.path").toString();
-    getProcess()->setProgram(cargoPath.isEmpty() ? "cargo" : cargoPath);
-    getProcess()->setArguments(arguments);
+void CargoManager::onErrorOccurred(ProcessJob* job, QProcess::ProcessError error) {
+    if (error == QProcess::FailedToStart) {
+        coloredOutputMessage(QString("%1: %2").arg(commands.value(job).title).arg(errorToString(error)));
+    }
+}
+
+ProcessJob* CargoManager::prepareAndStart(const QStringList& arguments, CommandStatus commandStatus) {
+    QString program = Global::getCargoPath();
 
-    QString message = getProcess()->program();
+    Command command;
+    command.status = commandStatus;
+    command.title = program;
     for (const auto& argument : arguments) {
-        message += " " + argument;
+        command.title += " " + argument;
+    }
+
+    // Output is not a terminal, so color has to be requested explicitly. Not for
+    // check, its rendered messages go to the issue list as plain text.
+    QString color = commandStatus == CommandStatus::Check ? "--color=never" : "--color=always";
+    ProcessJob* job = createJob(program, QStringList() << color << arguments);
+    commands[job] = command;
+    startJob(job);
+
+    return job;
+}
+
+void CargoManager::parseRunMessage(ProcessJob* job, const QString& line) {
+    if (!line.startsWith('{')) {
+        emit consoleMessage(line + "\n");
+        return;
+    }
+
+    QJsonObject obj = QJsonDocument::fromJson(line.toUtf8()).object();
+    QString reason = obj["reason"].toString();
+
+    if (reason == "compiler-message") {
+        emit consoleMessage(obj["message"].toObject()["rendered"].toString());
+    } else if (reason == "compiler-artifact" && obj["executable"].isString()) {
+        QJsonArray kinds = obj["target"].toObject()["kind"].toArray();
+        if (kinds.contains("bin")) {
+            commands[job].executable = obj["executable"].toString();
+        }
+    }
+}
+
+void CargoManager::launch(const QString& executable, bool clearConsole) {
+    QStringList arguments;
+    for (const QString& argument : projectProperties->getArgumentsList()) {
+        if (!argument.isEmpty()) {
+            arguments << argument;
+        }
+    }
+
+    Command command;
+    command.status = CommandStatus::Launch;
+    command.title = (QStringList() << executable << arguments).join(' ');
+    command.clearConsole = clearConsole;
+
+    ProcessJob* job = createJob(executable, arguments);
+    job->setProcessEnvironment(getRunEnvironment(executable));
+    commands[job] = command;
+    startJob(job);
+}
+
+QProcessEnvironment CargoManager::getRunEnvironment(const QString& executable) const {
+    // What cargo run sets for the program.
+    QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+    QJsonObject package = projectProperties->getPackage();
+
+    QString manifestPath = package["manifest_path"].toString();
+    environment.insert("CARGO", Global::getCargoPath());
+    environment.insert("CARGO_MANIFEST_DIR", manifestPath.isEmpty() ? projectPath : QFileInfo(manifestPath).absolutePath());
+
+    QString version = package["version"].toString();
+    QString pre = version.section('-', 1);
+    QStringList numbers = version.section('-', 0, 0).section('+', 0, 0).split('.');
+
+    environment.insert("CARGO_PKG_NAME", package["name"].toString());
+    environment.insert("CARGO_PKG_VERSION", version);
+    environment.insert("CARGO_PKG_VERSION_MAJOR", numbers.value(0));
+    environment.insert("CARGO_PKG_VERSION_MINOR", numbers.value(1));
+    environment.insert("CARGO_PKG_VERSION_PATCH", numbers.value(2));
+    environment.insert("CARGO_PKG_VERSION_PRE", pre.section('+', 0, 0));
+
+    QStringList authors;
+    for (const QJsonValue& author : package["authors"].toArray()) {
+        authors.append(author.toString());
+    }
+
+    environment.insert("CARGO_PKG_AUTHORS", authors.join(':'));
+    environment.insert("CARGO_PKG_DESCRIPTION", package["description"].toString());
+    environment.insert("CARGO_PKG_HOMEPAGE", package["homepage"].toString());
+    environment.insert("CARGO_PKG_REPOSITORY", package["repository"].toString());
+    environment.insert("CARGO_PKG_LICENSE", package["license"].toString());
+    environment.insert("CARGO_PKG_LICENSE_FILE", package["license_file"].toString());
+    environment.insert("CARGO_PKG_RUST_VERSION", package["rust_version"].toString());
+
+    // Dynamic libraries of dependencies are found next to the executable.
+#if defined(Q_OS_WIN)
+    const QString libraryPathName = "PATH";
+#elif defined(Q_OS_MAC)
+    const QString libraryPathName = "DYLD_FALLBACK_LIBRARY_PATH";
+#else
+    const QString libraryPathName = "LD_LIBRARY_PATH";
+#endif
+
+    QString outputDirectory = QFileInfo(executable).absolutePath();
+    QStringList libraryPaths;
+    libraryPaths << QDir::toNativeSeparators(outputDirectory + "/deps") << QDir::toNativeSeparators(outputDirectory);
+    if (environment.contains(libraryPathName)) {
+        libraryPaths << environment.value(libraryPathName);
     }
 
-    message += "<br>";
+    environment.insert(libraryPathName, libraryPaths.join(QDir::listSeparator()));
 
-    coloredOutputMessage(message, true);
-    getProcess()->start();
+    return environment;
+}
+
+bool CargoManager::isRunStampValid(const QString& executable, const QString& sourcesStamp) const {
+    QFileInfo fi(executable);
+    if (!fi.exists()) return false;
+
+    QFile file(projectPath + "/" + Constants::PROJECT_DATA_DIRECTORY + "/" + Constants::PROJECT_RUN_FILE);
+    if (!file.open(QIODevice::ReadOnly)) return false;
+
+    QJsonObject stamp = QJsonDocument::fromJson(file.readAll()).object()[executable].toObject();
+    return stamp["sources"].toString() == sourcesStamp
+            && stamp["modified"].toString() == QString::number(fi.lastModified().toMSecsSinceEpoch());
+}
+
+void CargoManager::saveRunStamp(const QString& executable, const QString& sourcesStamp) {
+    QString path = projectPath + "/" + Constants::PROJECT_DATA_DIRECTORY + "/" + Constants::PROJECT_RUN_FILE;
+
+    QJsonObject stamps;
+    QFile stampFile(path);
+    if (stampFile.open(QIODevice::ReadOnly)) {
+        stamps = QJsonDocument::fromJson(stampFile.readAll()).object();
+        stampFile.close();
+    }
+
+    QJsonObject stamp;
+    stamp["sources"] = sourcesStamp;
+    stamp["modified"] = QString::number(QFileInfo(executable).lastModified().toMSecsSinceEpoch());
+    stamps[executable] = stamp;
+
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open run stamp file for writing" << path;
+        return;
+    }
+
+    file.write(QJsonDocument(stamps).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qWarning() << "Failed to write run stamp file" << path << file.errorString();
+    }
 }
 
 void CargoManager::coloredOutputMessage(const QString& message, bool start) {
-    QString coloredMessage = QString("<font color=%1>%2</font>")
-            .arg("#0000FF")
-            .arg(message);
-    emit consoleMessage(coloredMessage, true, start);
+    // Blue foreground
+    emit consoleMessage("\x1b[34m" + message + "\x1b[0m\n", start);
+}
+
+void CargoManager::parseCheckMessage(const QString& line) {
+    if (line.trimmed().isEmpty()) return;
+
+    QJsonObject obj = QJsonDocument::fromJson(line.toUtf8()).object();
+    if (obj["reason"].toString() != "compiler-message") return;
+
+    QJsonObject message = obj["message"].toObject();
+
+    for (const auto& value : message["spans"].toArray()) {
+        QJsonObject span = value.toObject();
+        if (!span["is_primary"].toBool()) continue;
+
+        Diagnostic diagnostic;
+        diagnostic.level = message["level"].toString();
+        diagnostic.message = message["message"].toString();
+        diagnostic.rendered = message["rendered"].toString();
+        diagnostic.filePath = QDir(projectPath).absoluteFilePath(span["file_name"].toString());
+        diagnostic.line = span["line_start"].toInt();
+        diagnostic.column = span["column_start"].toInt();
+        checkDiagnostics.append(diagnostic);
+        break;
+    }
 }
@@ -1,8 +1,11 @@
 #pragma once
 #include "ProcessManager.h"
-#include <QTime>
+#include <QHash>
+#include <QVector>
+#include <QProcessEnvironment>
 
 class ProjectProperties;
+class QThreadPool;
 
 class CargoManager : public ProcessManager {
     Q_OBJECT
@@ -17,38 +20,105 @@ public:
         Release
     };
 
+    struct Diagnostic {
+        QString level;
+        QString message;
+        QString rendered;
+        QString filePath;
+        int line = 0;
+        int column = 0;
+    };
+
     explicit CargoManager(ProjectProperties* projectProperties, QObject* parent = nullptr);
     ~CargoManager();
 
     void createProject(ProjectTemplate projectTemplate, const QString& path);
     void build();
+    void buildWithTimings();
     void run();
+    void bench();
+    void emitCode(const QString& emitType);
     void clean();
 
+    void check();
+    void cancelCheck();
+
+    // Runs the command of watch mode, replacing a run that is still going.
+    void watch();
+    void cancelWatch();
+
     void setProjectPath(const QString& path);
+    QString getTargetPath() const;
 
 signals:
-    void consoleMessage(const QString& message, bool html = false, bool start = false);
+    void consoleMessage(const QString& message, bool start = false);
     void projectCreated(const QString& path);
+    void checkFinished(const QVector<CargoManager::Diagnostic>& diagnostics);
+    void timingsReady(const QString& reportPath);
+    void benchFinished(const QString& criterionPath);
+    // An empty path if the emit failed or produced no output.
+    void codegenEmitted(const QString& outputPath);
+    // Internal, delivers a sources stamp computed on the pool for run().
+    void sourcesStampReady(int request, const QString& sourcesStamp);
 
 private slots:
-    void onReadyReadStandardOutput(const QString& data) override;
-    void onReadyReadStandardError(const QString& data) override;
-    void onFinished(int exitCode, QProcess::ExitStatus exitStatus) override;
+    void onStarted(ProcessJob* job) override;
+    void onReadyReadStandardOutput(ProcessJob* job, const QString& data) override;
+    void onReadyReadStandardError(ProcessJob* job, const QString& data) override;
+    void onFinished(ProcessJob* job, int exitCode, QProcess::ExitStatus exitStatus) override;
+    void onErrorOccurred(ProcessJob* job, QProcess::ProcessError error) override;
 
 private:
-    void prepareAndStart(const QStringList& arguments);
-
     enum class CommandStatus {
         None,
         New,
         Build,
-        Run
+        BuildTimings,
+        Run,
+        Launch,
+        Bench,
+        Emit,
+        Check,
+        Watch
     };
 
+    struct Command {
+        CommandStatus status = CommandStatus::None;
+        QString title;
+        QString outputSuffix;
+        // Emit: crate name the output file starts with and the directory it is in.
+        QString outputCrate;
+        QString outputDirectory;
+        bool clearConsole = true;
+        // Run: build output is parsed to find the executable.
+        QString buffer;
+        QString executable;
+        QString sourcesStamp;
+    };
+
+    ProcessJob* prepareAndStart(const QStringList& arguments, CommandStatus commandStatus = CommandStatus::None);
     void coloredOutputMessage(const QString& message, bool start = false);
+    void parseCheckMessage(const QString& line);
+    void parseRunMessage(ProcessJob* job, const QString& line);
+    void onSourcesStampReady(int request, const QString& sourcesStamp);
+    void runWithCargo(const QString& kind, const QString& target);
+    void launch(const QString& executable, bool clearConsole);
+    QProcessEnvironment getRunEnvironment(const QString& executable) const;
+    bool isRunStampValid(const QString& executable, const QString& sourcesStamp) const;
+    void saveRunStamp(const QString& executable, const QString& sourcesStamp);
 
     ProjectProperties* projectProperties;
-    CommandStatus commandStatus = CommandStatus::None;
+    QHash<ProcessJob*, Command> commands;
     QString projectPath;
+
+    // Only the latest check is reported, older ones are killed.
+    ProcessJob* checkJob = nullptr;
+    QString checkBuffer;
+    QVector<Diagnostic> checkDiagnostics;
+
+    ProcessJob* watchJob = nullptr;
+
+    // Only the latest Run continues once its stamp is computed.
+    QThreadPool* stampPool;
+    int runRequest = 0;
 };
@@ -0,0 +1,444 @@
+#include "CodegenIndex.h"
+#include <QtCore>
+
+// Value of "name: value" in an LLVM metadata node, quotes removed.
+static QByteArray getMetadataField(const QByteArray& line, const QByteArray& name) {
+    int begin = line.indexOf(name + ": ");
+    if (begin == -1) return QByteArray();
+
+    begin += name.size() + 2;
+    if (begin < line.size() && line.at(begin) == '"') {
+        int end = line.indexOf('"', begin + 1);
+        return end == -1 ? QByteArray() : line.mid(begin + 1, end - begin - 1);
+    }
+
+    int end = begin;
+    while (end < line.size() && line.at(end) != ',' && line.at(end) != ')') {
+        end++;
+    }
+
+    return line.mid(begin, end - begin);
+}
+
+static int getMetadataId(const QByteArray& value) {
+    // !123
+    return value.startsWith('!') ? value.mid(1).toInt() : -1;
+}
+
+// Parses a legacy mangled Rust symbol (_ZN3foo3bar17h0123456789abcdefE) at start.
+static bool demangleAt(const QString& text, int start, int& length, QString& result) {
+    int i = start + 3;
+    QStringList parts;
+
+    while (i < text.size() && text.at(i).isDigit()) {
+        int size = 0;
+        while (i < text.size() && text.at(i).isDigit()) {
+            size = size * 10 + text.at(i).digitValue();
+            i++;
+        }
+
+        if (size == 0 || i + size > text.size()) return false;
+
+        parts.append(text.mid(i, size));
+        i += size;
+    }
+
+    if (parts.isEmpty() || i >= text.size() || text.at(i) != 'E') return false;
+    length = i + 1 - start;
+
+    static const QRegularExpression hashRegExp("^h[0-9a-f]{16}$");
+    if (parts.count() > 1 && hashRegExp.match(parts.last()).hasMatch()) {
+        parts.removeLast();
+    }
+
+    static const QHash<QString, QString> escapes = {
+        { "SP", "@" }, { "BP", "*" }, { "RF", "&" }, { "LT", "<" },
+        { "GT", ">" }, { "LP", "(" }, { "RP", ")" }, { "C", "," }
+    };
+
+    for (QString& part : parts) {
+        if (part.startsWith("_$")) {
+            part.remove(0, 1);
+        }
+
+        QString decoded;
+        for (int j = 0; j < part.size(); j++) {
+            if (part.at(j) == '$') {
+                int end = part.indexOf('$', j + 1);
+                if (end != -1) {
+                    QString escape = part.mid(j + 1, end - j - 1);
+                    bool ok = false;
+                    if (escapes.contains(escape)) {
+                        decoded += escapes.value(escape);
+                        ok = true;
+                    } else if (escape.startsWith('u')) {
+                        ushort code = escape.mid(1).toUShort(&ok, 16);
+                        if (ok) {
+                            decoded += QChar(code);
+                        }
+                    }
+
+                    if (ok) {
+                        j = end;
+                        continue;
+                    }
+                }
+            } else if (part.midRef(j, 2) == "..") {
+                decoded += "::";
+                j++;
+                continue;
+            }
+
+            decoded += part.at(j);
+        }
+
+        part = decoded;
+    }
+
+    result = parts.join("::");
+    return true;
+}
+
+bool CodegenIndex::build(const QString& filePath, Kind kind) {
+    clear();
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open codegen output for reading" << filePath;
+        return false;
+    }
+
+    this->filePath = filePath;
+    this->kind = kind;
+    lastModified = QFileInfo(file).lastModified();
+
+    bool result = kind == Kind::Assembly ? buildAssembly(file) : buildLlvmIr(file);
+    currentRanges.clear();
+
+    return result;
+}
+
+void CodegenIndex::clear() {
+    filePath.clear();
+    lastModified = QDateTime();
+    functions.clear();
+    files.clear();
+    ranges.clear();
+    fileNumbers.clear();
+    debugLocations.clear();
+    currentRanges.clear();
+}
+
+bool CodegenIndex::isBuiltFrom(const QString& filePath) const {
+    return !this->filePath.isEmpty() && this->filePath == filePath
+            && QFileInfo(filePath).lastModified() == lastModified;
+}
+
+int CodegenIndex::findFunction(const QString& sourcePath, int line) const {
+    int result = -1;
+    int resultSpan = 0;
+
+    for (const Range& range : ranges.value(QDir::cleanPath(sourcePath))) {
+        int span = range.last - range.first;
+        if (line >= range.first && line <= range.last && (result == -1 || span < resultSpan)) {
+            result = range.function;
+            resultSpan = span;
+        }
+    }
+
+    return result;
+}
+
+CodegenIndex::Listing CodegenIndex::getListing(int function) const {
+    Listing listing;
+    if (function < 0 || function >= functions.count()) return listing;
+
+    listing.name = demangle(functions.at(function).name);
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly) || !file.seek(functions.at(function).offset)) {
+        qWarning() << "Failed to read codegen output" << filePath;
+        return listing;
+    }
+
+    QList<QByteArray> lines = file.read(functions.at(function).length).split('\n');
+    Location location;
+
+    for (const QByteArray& line : lines) {
+        QByteArray trimmed = line.trimmed();
+        if (trimmed.isEmpty()) continue;
+
+        if (kind == Kind::Assembly) {
+            if (trimmed.startsWith(".loc")) {
+                QList<QByteArray> tokens = trimmed.simplified().split(' ');
+                if (tokens.count() >= 3) {
+                    location.file = fileNumbers.value(tokens.at(1).toInt(), -1);
+                    location.line = tokens.at(2).toInt();
+                }
+                continue;
+            }
+
+            // Directives and local labels are noise when reading code.
+            if (trimmed.startsWith('.') && (!trimmed.endsWith(':') || trimmed.startsWith(".Ltmp") || trimmed.startsWith(".Lfunc_end"))) {
+                continue;
+            }
+        } else {
+            location = Location();
+
+            int dbg = line.lastIndexOf("!dbg !");
+            if (dbg != -1) {
+                int begin = dbg + 6;
+                int end = begin;
+                while (end < line.size() && isdigit(static_cast<unsigned char>(line.at(end)))) {
+                    end++;
+                }
+                location = debugLocations.value(line.mid(begin, end - begin).toInt());
+            }
+        }
+
+        listing.lines.append(demangleAll(QString::fromUtf8(line)));
+        listing.locations.append(location);
+    }
+
+    return listing;
+}
+
+QString CodegenIndex::demangle(const QString& symbol) {
+    // Mach-O adds another leading underscore.
+    int start = symbol.startsWith("__ZN") ? 1 : 0;
+    if (symbol.midRef(start, 3) != "_ZN") return symbol;
+
+    int length;
+    QString result;
+    if (!demangleAt(symbol, start, length, result)) return symbol;
+
+    // Keep suffixes such as .llvm.123456.
+    return result + symbol.mid(start + length);
+}
+
+QString CodegenIndex::demangleAll(const QString& text) {
+    int index = text.indexOf("_ZN");
+    if (index == -1) return text;
+
+    QString result;
+    int copied = 0;
+
+    while (index != -1) {
+        int length;
+        QString demangled;
+        if (demangleAt(text, index, length, demangled)) {
+            result += text.midRef(copied, index - copied);
+            result += demangled;
+            copied = index + length;
+            index = text.indexOf("_ZN", copied);
+        } else {
+            index = text.indexOf("_ZN", index + 3);
+        }
+    }
+
+    result += text.midRef(copied);
+    return result;
+}
+
+bool CodegenIndex::buildAssembly(QFile& file) {
+    // ELF output declares functions with .type, Mach-O has no such directive
+    // and global symbols start with an underscore.
+    QSet<QByteArray> functionSymbols;
+    bool hasTypes = false;
+    bool inFunction = false;
+
+    while (!file.atEnd()) {
+        qint64 pos = file.pos();
+        QByteArray line = file.readLine();
+        QByteArray trimmed = line.trimmed();
+
+        if (trimmed.startsWith(".type")) {
+            // .type	name,@function
+            int comma = trimmed.lastIndexOf(',');
+            if (comma != -1 && trimmed.mid(comma + 1) == "@function") {
+                QByteArray symbol = trimmed.mid(5, comma - 5).trimmed();
+                if (symbol.startsWith('"')) {
+                    symbol = symbol.mid(1, symbol.size() - 2);
+                }
+                functionSymbols.insert(symbol);
+                hasTypes = true;
+            }
+        } else if (trimmed.startsWith(".file")) {
+            // .file	1 "/path/to/project" "src/main.rs"
+            QList<QByteArray> strings;
+            QList<QByteArray> parts = trimmed.split('"');
+            for (int i = 1; i < parts.count(); i += 2) {
+                strings.append(parts.at(i));
+            }
+
+            bool ok;
+            int number = parts.first().mid(5).trimmed().toInt(&ok);
+            if (ok && !strings.isEmpty()) {
+                QString directory = strings.count() > 1 ? QString::fromUtf8(strings.at(0)) : QString();
+                fileNumbers[number] = addFile(directory, QString::fromUtf8(strings.last()));
+            }
+        } else if (trimmed.startsWith(".loc")) {
+            if (inFunction) {
+                QList<QByteArray> tokens = trimmed.simplified().split(' ');
+                if (tokens.count() >= 3) {
+                    Location location;
+                    location.file = fileNumbers.value(tokens.at(1).toInt(), -1);
+                    location.line = tokens.at(2).toInt();
+                    addLocation(location);
+                }
+            }
+        } else if (!line.isEmpty() && !isspace(static_cast<unsigned char>(line.at(0))) && trimmed.endsWith(':')) {
+            QByteArray label = trimmed.left(trimmed.size() - 1);
+            if (label.startsWith('"')) {
+                label = label.mid(1, label.size() - 2);
+            }
+
+            if (label.startsWith(".Lfunc_end")) {
+                if (inFunction) {
+                    finishFunction(file.pos());
+                    inFunction = false;
+                }
+            } else if (hasTypes ? functionSymbols.contains(label) : label.startsWith('_')) {
+                if (inFunction) {
+                    finishFunction(pos);
+                }
+
+                Function function;
+                function.name = QString::fromUtf8(label);
+                function.offset = pos;
+                functions.append(function);
+                inFunction = true;
+            }
+        }
+    }
+
+    if (inFunction) {
+        finishFunction(file.pos());
+    }
+
+    return true;
+}
+
+bool CodegenIndex::buildLlvmIr(QFile& file) {
+    // Debug metadata is at the end of the file, so a first pass resolves
+    // !DILocation ids to files and lines before function bodies are scanned.
+    QHash<int, int> metadataFiles;
+    QHash<int, int> scopeFiles;
+    QHash<int, QPair<int, int>> locationScopes;
+
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        if (line.size() < 2 || line.at(0) != '!' || !isdigit(static_cast<unsigned char>(line.at(1)))) continue;
+
+        int id = line.mid(1, line.indexOf(' ') - 1).toInt();
+
+        if (line.contains("!DILocation(")) {
+            int scope = getMetadataId(getMetadataField(line, "scope"));
+            locationScopes[id] = qMakePair(scope, getMetadataField(line, "line").toInt());
+        } else if (line.contains("!DIFile(")) {
+            QString fileName = QString::fromUtf8(getMetadataField(line, "filename"));
+            QString directory = QString::fromUtf8(getMetadataField(line, "directory"));
+            metadataFiles[id] = addFile(directory, fileName);
+        } else {
+            // Subprograms and lexical blocks name their file.
+            int fileId = getMetadataId(getMetadataField(line, "file"));
+            if (fileId != -1) {
+                scopeFiles[id] = fileId;
+            }
+        }
+    }
+
+    for (auto it = locationScopes.constBegin(); it != locationScopes.constEnd(); ++it) {
+        Location location;
+        location.file = metadataFiles.value(scopeFiles.value(it.value().first, -1), -1);
+        location.line = it.value().second;
+        debugLocations[it.key()] = location;
+    }
+
+    locationScopes.clear();
+
+    if (!file.seek(0)) return false;
+
+    bool inFunction = false;
+
+    while (!file.atEnd()) {
+        qint64 pos = file.pos();
+        QByteArray line = file.readLine();
+
+        if (line.startsWith("define ")) {
+            // define internal void @_ZN4test4main17h0123456789abcdefE() unnamed_addr #0 !dbg !12 {
+            int at = line.indexOf('@');
+            if (at == -1) continue;
+
+            QByteArray name;
+            if (at + 1 < line.size() && line.at(at + 1) == '"') {
+                name = line.mid(at + 2, line.indexOf('"', at + 2) - at - 2);
+            } else {
+                name = line.mid(at + 1, line.indexOf('(', at) - at - 1);
+            }
+
+            Function function;
+            function.name = QString::fromUtf8(name);
+            function.offset = pos;
+            functions.append(function);
+            inFunction = true;
+        } else if (inFunction) {
+            if (line.startsWith('}')) {
+                finishFunction(file.pos());
+                inFunction = false;
+                continue;
+            }
+
+            int dbg = line.lastIndexOf("!dbg !");
+            if (dbg != -1) {
+                int begin = dbg + 6;
+                int end = begin;
+                while (end < line.size() && isdigit(static_cast<unsigned char>(line.at(end)))) {
+                    end++;
+                }
+                addLocation(debugLocations.value(line.mid(begin, end - begin).toInt()));
+            }
+        }
+    }
+
+    return true;
+}
+
+int CodegenIndex::addFile(const QString& directory, const QString& fileName) {
+    QString path = QDir::cleanPath(directory.isEmpty() ? fileName : QDir(directory).absoluteFilePath(fileName));
+
+    int index = files.indexOf(path);
+    if (index == -1) {
+        files.append(path);
+        index = files.count() - 1;
+    }
+
+    return index;
+}
+
+void CodegenIndex::addLocation(const Location& location) {
+    if (location.file < 0 || location.line <= 0) return;
+
+    auto it = currentRanges.find(location.file);
+    if (it == currentRanges.end()) {
+        currentRanges.insert(location.file, qMakePair(location.line, location.line));
+    } else {
+        it.value().first = qMin(it.value().first, location.line);
+        it.value().second = qMax(it.value().second, location.line);
+    }
+}
+
+void CodegenIndex::finishFunction(qint64 end) {
+    Function& function = functions.last();
+    function.length = end - function.offset;
+
+    for (auto it = currentRanges.constBegin(); it != currentRanges.constEnd(); ++it) {
+        Range range;
+        range.function = functions.count() - 1;
+        range.first = it.value().first;
+        range.last = it.value().second;
+        ranges[files.at(it.key())].append(range);
+    }
+
+    currentRanges.clear();
+}
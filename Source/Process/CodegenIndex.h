@@ -0,0 +1,78 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include <QDateTime>
+
+class QFile;
+
+// Function offsets and source line ranges of an assembly (.s) or LLVM IR (.ll)
+// file emitted by rustc. The file is scanned once, function bodies are read
+// back from disk only when shown.
+class CodegenIndex {
+public:
+    enum class Kind {
+        Assembly,
+        LlvmIr
+    };
+
+    struct Location {
+        int file = -1;
+        int line = 0;
+    };
+
+    struct Listing {
+        QString name;
+        QStringList lines;
+        QVector<Location> locations;
+    };
+
+    bool build(const QString& filePath, Kind kind);
+    void clear();
+
+    bool isBuiltFrom(const QString& filePath) const;
+    int getFunctionCount() const { return functions.count(); }
+
+    // Function with the narrowest line range covering the line, -1 if none.
+    int findFunction(const QString& sourcePath, int line) const;
+    Listing getListing(int function) const;
+    QString getSourcePath(int file) const { return files.value(file); }
+
+    static QString demangle(const QString& symbol);
+    static QString demangleAll(const QString& text);
+
+private:
+    struct Function {
+        QString name;
+        qint64 offset = 0;
+        qint64 length = 0;
+    };
+
+    struct Range {
+        int function;
+        int first;
+        int last;
+    };
+
+    bool buildAssembly(QFile& file);
+    bool buildLlvmIr(QFile& file);
+    int addFile(const QString& directory, const QString& fileName);
+    void addLocation(const Location& location);
+    void finishFunction(qint64 end);
+
+    Kind kind = Kind::Assembly;
+    QString filePath;
+    QDateTime lastModified;
+
+    QVector<Function> functions;
+    QStringList files;
+    QHash<QString, QVector<Range>> ranges;
+
+    // Assembly .file numbers and LLVM IR !DILocation ids.
+    QHash<int, int> fileNumbers;
+    QHash<int, Location> debugLocations;
+
+    // Line range per file of the function being scanned.
+    QHash<int, QPair<int, int>> currentRanges;
+};
@@ -0,0 +1,455 @@
+#include "HeapProfile.h"
+#include <QtCore>
+#include <algorithm>
+
+static const int READ_CHUNK_SIZE = 64 * 1024;
+
+// Pull parser over a device. Only the current chunk is held in memory,
+// values that are not needed are skipped without being built.
+class JsonStreamReader {
+public:
+    explicit JsonStreamReader(QIODevice* device) : device(device) {}
+
+    bool hasError() const { return error; }
+
+    char peek() {
+        skipWhitespace();
+        return current();
+    }
+
+    bool consume(char c) {
+        if (peek() != c) return false;
+        pos++;
+        return true;
+    }
+
+    void expect(char c) {
+        if (!consume(c)) {
+            error = true;
+        }
+    }
+
+    QString readString() {
+        QByteArray utf8;
+        readString(&utf8);
+        return QString::fromUtf8(utf8);
+    }
+
+    double readNumber() {
+        QByteArray number;
+        skipWhitespace();
+        for (char c = current(); c && ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E'); c = current()) {
+            number += c;
+            pos++;
+        }
+
+        bool ok;
+        double value = number.toDouble(&ok);
+        if (!ok) {
+            error = true;
+        }
+
+        return value;
+    }
+
+    void skipValue() {
+        char c = peek();
+
+        if (c == '{' || c == '[') {
+            char end = c == '{' ? '}' : ']';
+            pos++;
+            if (consume(end)) return;
+
+            do {
+                if (c == '{') {
+                    readString(nullptr);
+                    expect(':');
+                }
+                skipValue();
+            } while (!error && consume(','));
+
+            expect(end);
+        } else if (c == '"') {
+            readString(nullptr);
+        } else if (c) {
+            // Number, true, false or null.
+            for (c = current(); c && c != ',' && c != '}' && c != ']' && !QChar::isSpace(c); c = current()) {
+                pos++;
+            }
+        } else {
+            error = true;
+        }
+    }
+
+private:
+    char current() {
+        if (pos >= buffer.size()) {
+            buffer = device->read(READ_CHUNK_SIZE);
+            pos = 0;
+            if (buffer.isEmpty()) return 0;
+        }
+
+        return buffer.at(pos);
+    }
+
+    void skipWhitespace() {
+        for (char c = current(); c == ' ' || c == '\n' || c == '\r' || c == '\t'; c = current()) {
+            pos++;
+        }
+    }
+
+    void readString(QByteArray* utf8) {
+        if (!consume('"')) {
+            error = true;
+            return;
+        }
+
+        QString escaped;
+
+        for (char c = current(); ; c = current()) {
+            if (!c) {
+                error = true;
+                return;
+            }
+
+            pos++;
+
+            if (c == '\\') {
+                char next = current();
+                pos++;
+
+                if (next == 'u') {
+                    QByteArray hex;
+                    for (int i = 0; i < 4; i++) {
+                        hex += current();
+                        pos++;
+                    }
+                    // Kept apart until the sequence ends so surrogate pairs stay intact.
+                    escaped += QChar(hex.toUShort(nullptr, 16));
+                    continue;
+                }
+
+                switch (next) {
+                    case 'n': c = '\n'; break;
+                    case 't': c = '\t'; break;
+                    case 'r': c = '\r'; break;
+                    case 'b': c = '\b'; break;
+                    case 'f': c = '\f'; break;
+                    default: c = next; break;
+                }
+            } else if (c == '"') {
+                if (utf8 && !escaped.isEmpty()) {
+                    *utf8 += escaped.toUtf8();
+                }
+                return;
+            }
+
+            if (utf8) {
+                if (!escaped.isEmpty()) {
+                    *utf8 += escaped.toUtf8();
+                    escaped.clear();
+                }
+                *utf8 += c;
+            }
+        }
+    }
+
+    QIODevice* device;
+    QByteArray buffer;
+    int pos = 0;
+    bool error = false;
+};
+
+bool HeapProfile::load(const QString& filePath) {
+    nodes.clear();
+    childIndices.clear();
+    frames.clear();
+    frameIds.clear();
+    children.clear();
+    command.clear();
+    timeUnit.clear();
+    errorString.clear();
+
+    nodes.append(Node());
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        errorString = file.errorString();
+        return false;
+    }
+
+    // DHAT writes JSON, massif a line based text format.
+    char first = 0;
+    while (file.peek(&first, 1) == 1 && QChar::isSpace(first)) {
+        file.read(1);
+    }
+
+    bool result;
+    if (first == '{') {
+        format = Format::Dhat;
+        result = loadDhat(&file);
+    } else {
+        format = Format::Massif;
+        result = loadMassif(&file);
+    }
+
+    finish();
+    return result;
+}
+
+QString HeapProfile::getFrame(int index) const {
+    int frame = nodes.at(index).frame;
+    return frame >= 0 && frame < frames.count() ? frames.at(frame) : QString();
+}
+
+bool HeapProfile::parseLocation(const QString& frame, QString& filePath, int& line, int& column) {
+    // 0x10A6E2: main (src/main.rs:5:13)
+    if (!frame.endsWith(')')) return false;
+
+    int begin = frame.lastIndexOf('(');
+    if (begin == -1) return false;
+
+    QStringList parts = frame.mid(begin + 1, frame.size() - begin - 2).split(':');
+    if (parts.count() < 2 || parts.first().startsWith("in ")) return false;
+
+    bool hasColumn = false;
+    bool hasLine = false;
+    column = parts.last().toInt(&hasColumn);
+    line = parts.at(parts.count() - 2).toInt(&hasLine);
+
+    if (hasColumn && hasLine && parts.count() >= 3) {
+        parts.removeLast();
+        parts.removeLast();
+    } else if (hasColumn) {
+        line = column;
+        column = 1;
+        parts.removeLast();
+    } else {
+        return false;
+    }
+
+    filePath = parts.join(':');
+    return true;
+}
+
+bool HeapProfile::loadDhat(QIODevice* device) {
+    JsonStreamReader reader(device);
+    QVector<int> stack;
+
+    reader.expect('{');
+    if (!reader.consume('}')) {
+        do {
+            QString key = reader.readString();
+            reader.expect(':');
+
+            if (key == "pps") {
+                // Program points are folded into the tree as they are read.
+                reader.expect('[');
+                if (reader.consume(']')) continue;
+
+                do {
+                    qint64 bytes = 0;
+                    qint64 blocks = 0;
+                    qint64 lifetime = 0;
+                    qint64 peakBytes = 0;
+                    stack.clear();
+
+                    reader.expect('{');
+                    do {
+                        QString field = reader.readString();
+                        reader.expect(':');
+
+                        if (field == "tb") {
+                            bytes = static_cast<qint64>(reader.readNumber());
+                        } else if (field == "tbk") {
+                            blocks = static_cast<qint64>(reader.readNumber());
+                        } else if (field == "tl") {
+                            lifetime = static_cast<qint64>(reader.readNumber());
+                        } else if (field == "gb") {
+                            peakBytes = static_cast<qint64>(reader.readNumber());
+                        } else if (field == "fs") {
+                            reader.expect('[');
+                            if (!reader.consume(']')) {
+                                do {
+                                    stack.append(static_cast<int>(reader.readNumber()));
+                                } while (!reader.hasError() && reader.consume(','));
+                                reader.expect(']');
+                            }
+                        } else {
+                            reader.skipValue();
+                        }
+                    } while (!reader.hasError() && reader.consume(','));
+                    reader.expect('}');
+
+                    // Frames are listed from the allocation site outwards and refer to "ftbl",
+                    // which comes later in the file, so indices are stored as they are.
+                    int index = ROOT;
+                    for (int i = -1; i < stack.count(); i++) {
+                        if (i >= 0) {
+                            index = findOrCreateChild(index, stack.at(i));
+                        }
+
+                        Node& node = nodes[index];
+                        node.bytes += bytes;
+                        node.blocks += blocks;
+                        node.lifetime += lifetime;
+                        node.peakBytes += peakBytes;
+                    }
+                } while (!reader.hasError() && reader.consume(','));
+                reader.expect(']');
+            } else if (key == "ftbl") {
+                reader.expect('[');
+                if (!reader.consume(']')) {
+                    do {
+                        frames.append(reader.readString());
+                    } while (!reader.hasError() && reader.consume(','));
+                    reader.expect(']');
+                }
+            } else if (key == "cmd") {
+                command = reader.readString();
+            } else if (key == "tu") {
+                timeUnit = reader.readString();
+            } else {
+                reader.skipValue();
+            }
+        } while (!reader.hasError() && reader.consume(','));
+        reader.expect('}');
+    }
+
+    if (reader.hasError()) {
+        errorString = QObject::tr("Malformed DHAT profile");
+        return false;
+    }
+
+    return true;
+}
+
+bool HeapProfile::loadMassif(QIODevice* device) {
+    // Only the peak snapshot is kept. Without one, the last detailed snapshot is read in a second pass.
+    qint64 lastDetailed = -1;
+
+    while (!device->atEnd()) {
+        QByteArray line = device->readLine().trimmed();
+
+        if (line.startsWith("cmd: ")) {
+            command = QString::fromUtf8(line.mid(5));
+        } else if (line.startsWith("time_unit: ")) {
+            timeUnit = QString::fromUtf8(line.mid(11));
+        } else if (line == "heap_tree=peak") {
+            return readMassifTree(device);
+        } else if (line == "heap_tree=detailed") {
+            lastDetailed = device->pos();
+        }
+    }
+
+    if (lastDetailed != -1 && device->seek(lastDetailed)) {
+        return readMassifTree(device);
+    }
+
+    errorString = QObject::tr("No detailed snapshot in massif profile");
+    return false;
+}
+
+bool HeapProfile::readMassifTree(QIODevice* device) {
+    // n2: 1000 (heap allocation functions) malloc/new/new[], --alloc-fns, etc.
+    //  n0: 600 0x4005F6: foo (main.rs:12)
+    static const QRegularExpression nodeRegExp("^( *)n(\\d+): (\\d+) (.*)$");
+
+    QVector<int> parents;
+
+    while (!device->atEnd()) {
+        QString line = QString::fromUtf8(device->readLine());
+        line.chop(line.endsWith("\r\n") ? 2 : (line.endsWith('\n') ? 1 : 0));
+
+        QRegularExpressionMatch match = nodeRegExp.match(line);
+        if (!match.hasMatch()) break;
+
+        int depth = match.capturedLength(1);
+        qint64 bytes = match.captured(3).toLongLong();
+
+        if (depth == 0) {
+            nodes[ROOT].bytes = bytes;
+            nodes[ROOT].peakBytes = bytes;
+            parents = { ROOT };
+            continue;
+        }
+
+        if (depth > parents.count()) {
+            errorString = QObject::tr("Malformed massif heap tree");
+            return false;
+        }
+
+        parents.resize(depth);
+        int index = addChild(parents.last(), intern(match.captured(4)));
+        nodes[index].bytes = bytes;
+        nodes[index].peakBytes = bytes;
+        parents.append(index);
+    }
+
+    return true;
+}
+
+int HeapProfile::addChild(int parent, int frame) {
+    Node node;
+    node.frame = frame;
+    node.parent = parent;
+    nodes.append(node);
+    return nodes.count() - 1;
+}
+
+int HeapProfile::findOrCreateChild(int parent, int frame) {
+    quint64 key = (static_cast<quint64>(parent) << 32) | static_cast<quint32>(frame);
+
+    auto it = children.find(key);
+    if (it != children.end()) return it.value();
+
+    int index = addChild(parent, frame);
+    children.insert(key, index);
+    return index;
+}
+
+int HeapProfile::intern(const QString& frame) {
+    auto it = frameIds.find(frame);
+    if (it != frameIds.end()) return it.value();
+
+    frames.append(frame);
+    frameIds.insert(frame, frames.count() - 1);
+    return frames.count() - 1;
+}
+
+void HeapProfile::finish() {
+    // Lookup tables are only needed while building.
+    children.clear();
+    children.squeeze();
+    frameIds.clear();
+    frameIds.squeeze();
+
+    // Lay out children contiguously per parent, largest first.
+    for (int i = 1; i < nodes.count(); i++) {
+        nodes[nodes.at(i).parent].childCount++;
+    }
+
+    int start = 0;
+    for (Node& node : nodes) {
+        node.childStart = start;
+        start += node.childCount;
+        node.childCount = 0;
+    }
+
+    childIndices.resize(start);
+    for (int i = 1; i < nodes.count(); i++) {
+        Node& parent = nodes[nodes.at(i).parent];
+        childIndices[parent.childStart + parent.childCount++] = i;
+    }
+
+    for (const Node& node : nodes) {
+        auto begin = childIndices.begin() + node.childStart;
+        std::sort(begin, begin + node.childCount, [this] (int a, int b) {
+            return nodes.at(a).bytes > nodes.at(b).bytes;
+        });
+
+        for (int row = 0; row < node.childCount; row++) {
+            nodes[*(begin + row)].row = row;
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+
+class QIODevice;
+
+// Allocation sites of a DHAT (dhat-heap.json) or massif (massif.out.*) profile.
+// Top level nodes are the allocating functions, children are their callers.
+class HeapProfile {
+public:
+    enum class Format {
+        Dhat,
+        Massif
+    };
+
+    struct Node {
+        int frame = -1;
+        int parent = -1;
+        int row = 0;
+        int childStart = 0;
+        int childCount = 0;
+        qint64 bytes = 0;
+        qint64 blocks = 0;
+        // Sum of block lifetimes, DHAT only.
+        qint64 lifetime = 0;
+        // Bytes live at the global heap peak.
+        qint64 peakBytes = 0;
+    };
+
+    bool load(const QString& filePath);
+
+    QString getErrorString() const { return errorString; }
+    Format getFormat() const { return format; }
+    QString getCommand() const { return command; }
+    QString getTimeUnit() const { return timeUnit; }
+
+    static const int ROOT = 0;
+
+    int getNodeCount() const { return nodes.count(); }
+    const Node& getNode(int index) const { return nodes.at(index); }
+    int getChild(int index, int row) const { return childIndices.at(nodes.at(index).childStart + row); }
+    QString getFrame(int index) const;
+
+    // Extracts "file.rs:line[:column]" from a frame description.
+    static bool parseLocation(const QString& frame, QString& filePath, int& line, int& column);
+
+private:
+    bool loadDhat(QIODevice* device);
+    bool loadMassif(QIODevice* device);
+    bool readMassifTree(QIODevice* device);
+    int addChild(int parent, int frame);
+    int findOrCreateChild(int parent, int frame);
+    int intern(const QString& frame);
+    void finish();
+
+    Format format = Format::Dhat;
+    QString errorString;
+    QString command;
+    QString timeUnit;
+
+    QVector<Node> nodes;
+    QVector<int> childIndices;
+    QStringList frames;
+    QHash<QString, int> frameIds;
+    QHash<quint64, int> children;
+};
@@ -0,0 +1,57 @@
+#include "JobScheduler.h"
+#include "ProcessJob.h"
+#include "Core/Preferences.h"
+#include <QtCore>
+
+JobScheduler::JobScheduler(QObject* parent) : QObject(parent) {
+    ioThread.setObjectName("ProcessIO");
+    ioThread.start();
+    Preferences* preferences = Preferences::getInstance();
+    setMaxJobs(preferences->getProcess().maxJobs);
+    connect(preferences, &Preferences::processChanged, this, [=] {
+        setMaxJobs(preferences->getProcess().maxJobs);
+    });
+}
+
+JobScheduler::~JobScheduler() {
+    // Workers still alive are deleted as the thread finishes, killing their processes.
+    ioThread.quit();
+    ioThread.wait();
+}
+
+void JobScheduler::enqueue(ProcessJob* job) {
+    connect(job, &ProcessJob::finished, this, &JobScheduler::onJobFinished);
+    connect(job, &QObject::destroyed, this, [=] {
+        remove(job);
+    });
+
+    queue.enqueue(job);
+    startNext();
+}
+
+void JobScheduler::setMaxJobs(int maxJobs) {
+    // Cargo already parallelizes each build across cores, so by default
+    // only a few jobs may run side by side.
+    this->maxJobs = maxJobs > 0 ? maxJobs : qMax(2, QThread::idealThreadCount() / 2);
+    startNext();
+}
+
+void JobScheduler::onJobFinished(ProcessJob* job) {
+    remove(job);
+    emit jobFinished(job);
+}
+
+void JobScheduler::startNext() {
+    while (running.count() < maxJobs && !queue.isEmpty()) {
+        ProcessJob* job = queue.dequeue();
+        running.append(job);
+        emit jobStarted(job);
+        job->start();
+    }
+}
+
+void JobScheduler::remove(ProcessJob* job) {
+    if (queue.removeOne(job) || running.removeOne(job)) {
+        startNext();
+    }
+}
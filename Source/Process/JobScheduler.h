@@ -0,0 +1,43 @@
+#pragma once
+#include "Core/Singleton.h"
+#include <QObject>
+#include <QQueue>
+#include <QThread>
+
+class ProcessJob;
+
+// Runs process jobs concurrently, keeping at most maxJobs of them running.
+// Process I/O of all jobs is done on a shared thread.
+class JobScheduler : public QObject, public Singleton<JobScheduler> {
+    Q_OBJECT
+
+public:
+    explicit JobScheduler(QObject* parent = nullptr);
+    ~JobScheduler();
+
+    void enqueue(ProcessJob* job);
+
+    void setMaxJobs(int maxJobs);
+    int getMaxJobs() const { return maxJobs; }
+
+    int getRunningCount() const { return running.count(); }
+    int getQueuedCount() const { return queue.count(); }
+
+    QThread* getIoThread() { return &ioThread; }
+
+signals:
+    void jobStarted(ProcessJob* job);
+    void jobFinished(ProcessJob* job);
+
+private slots:
+    void onJobFinished(ProcessJob* job);
+
+private:
+    void startNext();
+    void remove(ProcessJob* job);
+
+    QQueue<ProcessJob*> queue;
+    QList<ProcessJob*> running;
+    int maxJobs = 1;
+    QThread ioThread;
+};
@@ -0,0 +1,102 @@
+#include "ProcessJob.h"
+#include "ProcessWorker.h"
+#include "JobScheduler.h"
+#include <QtCore>
+
+int ProcessJob::nextId = 1;
+
+ProcessJob::ProcessJob(const QString& program, const QStringList& arguments, QObject* parent) :
+        QObject(parent),
+        id(nextId++),
+        program(program),
+        arguments(arguments) {
+}
+
+ProcessJob::~ProcessJob() {
+    if (worker) {
+        // Don't let the dying process call back into this object.
+        // The worker kills the process when it is deleted.
+        worker->disconnect(this);
+        worker->deleteLater();
+    }
+}
+
+QString ProcessJob::getCommandLine() const {
+    return arguments.isEmpty() ? program : program + " " + arguments.join(' ');
+}
+
+void ProcessJob::setWorkingDirectory(const QString& path) {
+    workingDirectory = path;
+}
+
+void ProcessJob::setProcessEnvironment(const QProcessEnvironment& environment) {
+    this->environment = environment;
+}
+
+qint64 ProcessJob::getElapsed() const {
+    return state == State::Running ? timer.elapsed() : elapsed;
+}
+
+void ProcessJob::start() {
+    if (state != State::Queued) return;
+
+    QThread* ioThread = JobScheduler::getInstance()->getIoThread();
+    worker = new ProcessWorker(program, arguments, workingDirectory);
+    worker->setProcessEnvironment(environment);
+    worker->moveToThread(ioThread);
+    connect(ioThread, &QThread::finished, worker, &QObject::deleteLater);
+
+    connect(worker, &ProcessWorker::output, this, [=] (const QString& outputData, const QString& errorData) {
+        if (!outputData.isEmpty()) {
+            emit standardOutput(this, outputData);
+        }
+
+        if (!errorData.isEmpty()) {
+            emit standardError(this, errorData);
+        }
+
+        if (worker) {
+            worker->acknowledge();
+        }
+    });
+
+    connect(worker, &ProcessWorker::finished, this,
+        [=] (int exitCode, QProcess::ExitStatus exitStatus) { finish(exitCode, exitStatus); });
+
+    connect(worker, &ProcessWorker::errorOccurred, this, [=] (QProcess::ProcessError error) {
+        emit errorOccurred(this, error);
+        // QProcess doesn't emit finished() for a process that never started.
+        if (error == QProcess::FailedToStart) {
+            finish(-1, QProcess::CrashExit);
+        }
+    });
+
+    state = State::Running;
+    timer.start();
+    emit started(this);
+
+    QMetaObject::invokeMethod(worker, "start", Qt::QueuedConnection);
+}
+
+void ProcessJob::cancel() {
+    if (state == State::Finished) return;
+
+    canceled = true;
+
+    if (state == State::Queued) {
+        finish(-1, QProcess::CrashExit);
+    } else if (worker) {
+        QMetaObject::invokeMethod(worker, "kill", Qt::QueuedConnection);
+    }
+}
+
+void ProcessJob::finish(int exitCode, QProcess::ExitStatus exitStatus) {
+    if (state == State::Finished) return;
+
+    this->exitCode = exitCode;
+    this->exitStatus = exitStatus;
+    elapsed = state == State::Running ? timer.elapsed() : 0;
+    state = State::Finished;
+
+    emit finished(this);
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <QObject>
+#include <QProcess>
+#include <QPointer>
+#include <QElapsedTimer>
+
+class ProcessWorker;
+
+// Single external process scheduled by JobScheduler. The process itself
+// runs on the scheduler's I/O thread, output arrives in line-split batches.
+class ProcessJob : public QObject {
+    Q_OBJECT
+public:
+    enum class State {
+        Queued,
+        Running,
+        Finished
+    };
+
+    explicit ProcessJob(const QString& program, const QStringList& arguments, QObject* parent = nullptr);
+    ~ProcessJob();
+
+    int getId() const { return id; }
+    QString getProgram() const { return program; }
+    QStringList getArguments() const { return arguments; }
+    QString getCommandLine() const;
+
+    void setWorkingDirectory(const QString& path);
+    QString getWorkingDirectory() const { return workingDirectory; }
+
+    // Empty by default, the process then inherits the environment.
+    void setProcessEnvironment(const QProcessEnvironment& environment);
+
+    State getState() const { return state; }
+    bool isCanceled() const { return canceled; }
+    int getExitCode() const { return exitCode; }
+    QProcess::ExitStatus getExitStatus() const { return exitStatus; }
+    qint64 getElapsed() const;
+
+    void start();
+    void cancel();
+
+signals:
+    void started(ProcessJob* job);
+    void standardOutput(ProcessJob* job, const QString& data);
+    void standardError(ProcessJob* job, const QString& data);
+    void finished(ProcessJob* job);
+    void errorOccurred(ProcessJob* job, QProcess::ProcessError error);
+
+private:
+    void finish(int exitCode, QProcess::ExitStatus exitStatus);
+
+    static int nextId;
+
+    int id;
+    QString program;
+    QStringList arguments;
+    QString workingDirectory;
+    QProcessEnvironment environment;
+    State state = State::Queued;
+    bool canceled = false;
+    int exitCode = -1;
+    QProcess::ExitStatus exitStatus = QProcess::NormalExit;
+    QElapsedTimer timer;
+    qint64 elapsed = 0;
+
+    // Lives on the I/O thread, deleted there when the thread finishes first.
+    QPointer<ProcessWorker> worker;
+};
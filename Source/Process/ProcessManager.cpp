@@ -1,49 +1,69 @@
 #include "ProcessManager.h"
+#include "ProcessJob.h"
+#include "JobScheduler.h"
 #include <QDebug>
 
 ProcessManager::ProcessManager(QObject* parent) : QObject(parent) {
-    process = new QProcess(this);
 
-    connect(process, &QProcess::readyReadStandardOutput, [=] {
-        const QByteArray& data = process->readAllStandardOutput();
-        const QString& output = outputCodec->toUnicode(data.constData(), data.length(), &outputCodecState);
-        onReadyReadStandardOutput(output);
-    });
+}
 
-    connect(process, &QProcess::readyReadStandardError, [=] {
-        const QByteArray& data = process->readAllStandardError();
-        const QString& output = outputCodec->toUnicode(data.constData(), data.length(), &errorCodecState);
-        onReadyReadStandardError(output);
-    });
+void ProcessManager::setWorkingDirectory(const QString& path) {
+    workingDirectory = path;
+}
+
+void ProcessManager::stop() {
+    // Canceling removes the job from the list.
+    const QList<ProcessJob*> activeJobs = jobs;
+    for (ProcessJob* job : activeJobs) {
+        job->cancel();
+    }
+}
+
+ProcessJob* ProcessManager::createJob(const QString& program, const QStringList& arguments) {
+    ProcessJob* job = new ProcessJob(program, arguments, this);
+    job->setWorkingDirectory(workingDirectory);
+    jobs.append(job);
 
-    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
-        [=] (int exitCode, QProcess::ExitStatus exitStatus) { onFinished(exitCode, exitStatus); });
+    connect(job, &ProcessJob::started, this, &ProcessManager::onStarted);
+    connect(job, &ProcessJob::standardOutput, this, &ProcessManager::onReadyReadStandardOutput);
+    connect(job, &ProcessJob::standardError, this, &ProcessManager::onReadyReadStandardError);
+    connect(job, &ProcessJob::errorOccurred, this, &ProcessManager::onErrorOccurred);
 
-    connect(process, &QProcess::errorOccurred, this, &ProcessManager::onErrorOccurred);
+    connect(job, &ProcessJob::finished, this, [=] {
+        jobs.removeOne(job);
+        onFinished(job, job->getExitCode(), job->getExitStatus());
+        job->deleteLater();
+    });
+
+    return job;
 }
 
-QProcess* ProcessManager::getProcess() {
-    return process;
+void ProcessManager::startJob(ProcessJob* job) {
+    JobScheduler::getInstance()->enqueue(job);
 }
 
-void ProcessManager::stop() {
-    process->kill();
+void ProcessManager::onStarted(ProcessJob* job) {
+    Q_UNUSED(job)
 }
 
-void ProcessManager::onReadyReadStandardOutput(const QString& data) {
+void ProcessManager::onReadyReadStandardOutput(ProcessJob* job, const QString& data) {
+    Q_UNUSED(job)
     Q_UNUSED(data)
 }
 
-void ProcessManager::onReadyReadStandardError(const QString& data) {
+void ProcessManager::onReadyReadStandardError(ProcessJob* job, const QString& data) {
+    Q_UNUSED(job)
     Q_UNUSED(data)
 }
 
-void ProcessManager::onFinished(int exitCode, QProcess::ExitStatus exitStatus) {
+void ProcessManager::onFinished(ProcessJob* job, int exitCode, QProcess::ExitStatus exitStatus) {
+    Q_UNUSED(job)
     Q_UNUSED(exitCode)
     Q_UNUSED(exitStatus)
 }
 
-void ProcessManager::onErrorOccurred(QProcess::ProcessError error) {
+void ProcessManager::onErrorOccurred(ProcessJob* job, QProcess::ProcessError error) {
+    Q_UNUSED(job)
     Q_UNUSED(error)
 }
 
@@ -1,27 +1,34 @@
 #pragma once
-#include "Core/Singleton.h"
+#include <QObject>
 #include <QProcess>
-#include <QTextCodec>
+
+class ProcessJob;
 
 class ProcessManager : public QObject {
     Q_OBJECT
 public:
     explicit ProcessManager(QObject* parent = nullptr);
-    QProcess* getProcess();
+
+    void setWorkingDirectory(const QString& path);
+    QString getWorkingDirectory() const { return workingDirectory; }
+
+    const QList<ProcessJob*>& getJobs() const { return jobs; }
+    bool isRunning() const { return !jobs.isEmpty(); }
     void stop();
 
 protected slots:
-    virtual void onReadyReadStandardOutput(const QString& data);
-    virtual void onReadyReadStandardError(const QString& data);
-    virtual void onFinished(int exitCode, QProcess::ExitStatus exitStatus);
-    virtual void onErrorOccurred(QProcess::ProcessError error);
+    virtual void onStarted(ProcessJob* job);
+    virtual void onReadyReadStandardOutput(ProcessJob* job, const QString& data);
+    virtual void onReadyReadStandardError(ProcessJob* job, const QString& data);
+    virtual void onFinished(ProcessJob* job, int exitCode, QProcess::ExitStatus exitStatus);
+    virtual void onErrorOccurred(ProcessJob* job, QProcess::ProcessError error);
 
 protected:
+    ProcessJob* createJob(const QString& program, const QStringList& arguments);
+    void startJob(ProcessJob* job);
     QString errorToString(QProcess::ProcessError error);
 
 private:
-    QProcess* process;
-    QTextCodec* outputCodec = QTextCodec::codecForLocale();
-    QTextCodec::ConverterState outputCodecState;
-    QTextCodec::ConverterState errorCodecState;
+    QString workingDirectory;
+    QList<ProcessJob*> jobs;
 };
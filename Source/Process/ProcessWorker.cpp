@@ -0,0 +1,117 @@
+#include "ProcessWorker.h"
+#include <QtCore>
+
+// At most this many batches per second reach the receiver.
+static const int FLUSH_INTERVAL = 30;
+// Longer lines are handed over before they are complete.
+static const int MAX_PARTIAL_LINE = 64 * 1024;
+
+ProcessWorker::ProcessWorker(const QString& program, const QStringList& arguments, const QString& workingDirectory) :
+        program(program),
+        arguments(arguments),
+        workingDirectory(workingDirectory) {
+}
+
+ProcessWorker::~ProcessWorker() {
+    if (process && process->state() != QProcess::NotRunning) {
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished();
+    }
+}
+
+void ProcessWorker::setProcessEnvironment(const QProcessEnvironment& environment) {
+    this->environment = environment;
+}
+
+void ProcessWorker::acknowledge() {
+    inFlight.storeRelease(0);
+}
+
+void ProcessWorker::start() {
+    process = new QProcess(this);
+    process->setWorkingDirectory(workingDirectory);
+    if (!environment.isEmpty()) {
+        process->setProcessEnvironment(environment);
+    }
+
+    flushTimer = new QTimer(this);
+    flushTimer->setInterval(FLUSH_INTERVAL);
+    connect(flushTimer, &QTimer::timeout, this, [=] {
+        flush(false);
+    });
+
+    connect(process, &QProcess::readyReadStandardOutput, this, [=] {
+        read(outputChannel, process->readAllStandardOutput());
+    });
+
+    connect(process, &QProcess::readyReadStandardError, this, [=] {
+        read(errorChannel, process->readAllStandardError());
+    });
+
+    connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this,
+        [=] (int exitCode, QProcess::ExitStatus exitStatus) {
+        read(outputChannel, process->readAllStandardOutput());
+        read(errorChannel, process->readAllStandardError());
+        flush(true);
+        emit finished(exitCode, exitStatus);
+    });
+
+    connect(process, &QProcess::errorOccurred, this, &ProcessWorker::errorOccurred);
+
+    process->start(program, arguments);
+}
+
+void ProcessWorker::kill() {
+    if (process) {
+        process->kill();
+    }
+}
+
+void ProcessWorker::read(Channel& channel, const QByteArray& data) {
+    if (data.isEmpty()) return;
+
+    channel.pending += codec->toUnicode(data.constData(), data.length(), &channel.codecState);
+    channel.received = true;
+
+    if (!flushTimer->isActive()) {
+        flushTimer->start();
+    }
+}
+
+void ProcessWorker::flush(bool final) {
+    // The final batch doesn't wait, queued signals arrive in order anyway.
+    if (!final && inFlight.loadAcquire()) return;
+
+    QString standardOutput = take(outputChannel, final);
+    QString standardError = take(errorChannel, final);
+
+    if (!standardOutput.isEmpty() || !standardError.isEmpty()) {
+        inFlight.storeRelease(1);
+        emit output(standardOutput, standardError);
+    }
+
+    if (outputChannel.pending.isEmpty() && errorChannel.pending.isEmpty()) {
+        flushTimer->stop();
+    }
+}
+
+QString ProcessWorker::take(Channel& channel, bool final) {
+    int end = channel.pending.size();
+
+    // An unfinished line is kept back while the process is still writing it,
+    // but handed over once it stalls, e.g. at a prompt or "test foo ... ".
+    if (!final && channel.received && end < MAX_PARTIAL_LINE) {
+        int i = end - 1;
+        while (i >= 0 && channel.pending.at(i) != '\n' && channel.pending.at(i) != '\r') {
+            i--;
+        }
+        end = i + 1;
+    }
+
+    channel.received = false;
+
+    QString result = channel.pending.left(end);
+    channel.pending.remove(0, end);
+    return result;
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <QObject>
+#include <QProcess>
+#include <QTextCodec>
+#include <QAtomicInt>
+
+class QTimer;
+
+// Runs the process of a ProcessJob on the I/O thread. Output is decoded and
+// split into lines there and handed over in batches, one batch at a time,
+// so a chatty process can't flood the GUI event loop.
+class ProcessWorker : public QObject {
+    Q_OBJECT
+public:
+    ProcessWorker(const QString& program, const QStringList& arguments, const QString& workingDirectory);
+    ~ProcessWorker();
+
+    // Set before start().
+    void setProcessEnvironment(const QProcessEnvironment& environment);
+
+    // Called by the receiver once it has handled a batch, from any thread.
+    void acknowledge();
+
+public slots:
+    void start();
+    void kill();
+
+signals:
+    void output(const QString& standardOutput, const QString& standardError);
+    void finished(int exitCode, QProcess::ExitStatus exitStatus);
+    void errorOccurred(QProcess::ProcessError error);
+
+private:
+    struct Channel {
+        QTextCodec::ConverterState codecState;
+        QString pending;
+        bool received = false;
+    };
+
+    void read(Channel& channel, const QByteArray& data);
+    void flush(bool final);
+    QString take(Channel& channel, bool final);
+
+    QString program;
+    QStringList arguments;
+    QString workingDirectory;
+    QProcessEnvironment environment;
+
+    QProcess* process = nullptr;
+    QTimer* flushTimer = nullptr;
+    QTextCodec* codec = QTextCodec::codecForLocale();
+    Channel outputChannel;
+    Channel errorChannel;
+    QAtomicInt inFlight;
+};
@@ -0,0 +1,227 @@
+#include "ProfileManager.h"
+#include "ProcessJob.h"
+#include "UI/ProjectProperties.h"
+#include "Core/Global.h"
+#include "Core/Constants.h"
+#include "Core/Preferences.h"
+#include <QtCore>
+#include <algorithm>
+
+ProfileManager::ProfileManager(ProjectProperties* projectProperties, QObject* parent) :
+        ProcessManager(parent),
+        projectProperties(projectProperties) {
+}
+
+bool ProfileManager::isAvailable() {
+    return !QStandardPaths::findExecutable("perf").isEmpty();
+}
+
+void ProfileManager::setProjectPath(const QString& path) {
+    projectPath = path;
+    setWorkingDirectory(path);
+}
+
+void ProfileManager::profile() {
+    stop();
+    currentJob = nullptr;
+
+    if (!isAvailable()) {
+        coloredOutputMessage(tr("Profiling requires perf, which was not found in PATH"), true);
+        return;
+    }
+
+    QString kind = projectProperties->getRunTargetKind();
+    if (kind != "bin" && kind != "example") {
+        coloredOutputMessage(tr("Only binaries and examples can be profiled"), true);
+        return;
+    }
+
+    binaryPath = projectProperties->getRunTarget();
+    dataPath = projectPath + "/" + Constants::PROJECT_DATA_DIRECTORY + "/" + Constants::PROJECT_PERF_DATA_FILE;
+    QDir().mkpath(QFileInfo(dataPath).absolutePath());
+
+    QStringList arguments;
+    arguments << "--color=always" << "build";
+    if (projectProperties->getBuildTarget() == CargoManager::BuildTarget::Release) {
+        arguments << "--release";
+    }
+    arguments << "--" + kind << QFileInfo(binaryPath).fileName();
+
+    coloredOutputMessage(tr("Profiling %1").arg(binaryPath), true);
+    startPhase(Phase::Build, Global::getCargoPath(), arguments);
+}
+
+void ProfileManager::record() {
+    // Otherwise a failed record would show the samples of the previous run.
+    QFile::remove(dataPath);
+
+    QStringList arguments;
+    arguments << "record";
+    arguments << "-F" << QString::number(Preferences::getInstance()->getProfile().frequency);
+    arguments << "--call-graph" << Preferences::getInstance()->getProfile().callGraph;
+    arguments << "-o" << dataPath;
+    arguments << "--" << binaryPath;
+
+    for (const QString& argument : projectProperties->getArgumentsList()) {
+        if (!argument.isEmpty()) {
+            arguments << argument;
+        }
+    }
+
+    startPhase(Phase::Record, "perf", arguments);
+}
+
+void ProfileManager::script() {
+    callTree.reset(new CallTree);
+    scriptBuffer.clear();
+    sampleFrames.clear();
+
+    // Symbols and source lines are resolved by perf, addresses are dropped.
+    // Full paths tell apart the many mod.rs and lib.rs files.
+    QStringList arguments;
+    arguments << "script";
+    arguments << "-i" << dataPath;
+    arguments << "-F" << "comm,ip,sym,dso,srcline";
+    arguments << "--full-source-path";
+
+    startPhase(Phase::Script, "perf", arguments);
+}
+
+void ProfileManager::startPhase(Phase phase, const QString& program, const QStringList& arguments) {
+    this->phase = phase;
+
+    if (phase != Phase::Script) {
+        coloredOutputMessage(program + " " + arguments.join(' '));
+    }
+
+    currentJob = createJob(program, arguments);
+    startJob(currentJob);
+}
+
+void ProfileManager::onReadyReadStandardOutput(ProcessJob* job, const QString& data) {
+    if (job != currentJob) return;
+
+    if (phase != Phase::Script) {
+        emit consoleMessage(data);
+        return;
+    }
+
+    scriptBuffer += data;
+    int begin = 0;
+    int end = scriptBuffer.indexOf('\n');
+    while (end != -1) {
+        parseScriptLine(scriptBuffer.mid(begin, end - begin));
+        begin = end + 1;
+        end = scriptBuffer.indexOf('\n', begin);
+    }
+    scriptBuffer.remove(0, begin);
+}
+
+void ProfileManager::onReadyReadStandardError(ProcessJob* job, const QString& data) {
+    if (job == currentJob) {
+        emit consoleMessage(data);
+    }
+}
+
+void ProfileManager::onFinished(ProcessJob* job, int exitCode, QProcess::ExitStatus exitStatus) {
+    if (job != currentJob) return;
+    currentJob = nullptr;
+
+    if (job->isCanceled()) {
+        coloredOutputMessage(tr("Profiling canceled"));
+        return;
+    }
+
+    bool success = exitStatus == QProcess::NormalExit && exitCode == 0;
+
+    switch (phase) {
+        case Phase::Build:
+            if (success) {
+                record();
+            } else {
+                coloredOutputMessage(tr("Profiling stopped, build failed"));
+            }
+            break;
+
+        case Phase::Record:
+            // The profiled program may exit with an error and still leave useful samples.
+            if (QFileInfo::exists(dataPath)) {
+                script();
+            } else {
+                coloredOutputMessage(tr("Profiling stopped, perf record failed with code %1").arg(exitCode));
+            }
+            break;
+
+        case Phase::Script:
+            parseScriptLine(scriptBuffer);
+            scriptBuffer.clear();
+            finishSample();
+
+            callTree->sortChildren();
+            coloredOutputMessage(tr("Profile ready: %1 samples, %2 call tree nodes (%3 s)")
+                    .arg(callTree->getSampleCount())
+                    .arg(callTree->getNodeCount())
+                    .arg(job->getElapsed() / 1000.0, 0, 'f', 2));
+            emit profileReady(callTree);
+            callTree.reset();
+            break;
+
+        default:
+            break;
+    }
+}
+
+void ProfileManager::onErrorOccurred(ProcessJob* job, QProcess::ProcessError error) {
+    if (job == currentJob && error == QProcess::FailedToStart) {
+        coloredOutputMessage(QString("%1: %2").arg(job->getProgram()).arg(errorToString(error)));
+    }
+}
+
+void ProfileManager::parseScriptLine(const QString& line) {
+    // Samples are separated by empty lines:
+    // comm
+    //     ip sym (dso)
+    //   file.rs:12
+    if (line.trimmed().isEmpty()) {
+        finishSample();
+        return;
+    }
+
+    if (!line.at(0).isSpace()) {
+        finishSample();
+        return;
+    }
+
+    static const QRegularExpression frameRegExp("^\\s*[0-9a-fA-F]+ (.+) \\((.*)\\)$");
+    QRegularExpressionMatch match = frameRegExp.match(line);
+    if (match.hasMatch()) {
+        CallTree::Frame frame;
+        frame.name = match.captured(1);
+        if (frame.name == "[unknown]") {
+            frame.name += " " + QFileInfo(match.captured(2)).fileName();
+        }
+        sampleFrames.append(frame);
+        return;
+    }
+
+    // Source line of the preceding frame, ??:0 if there is no debug info.
+    if (!sampleFrames.isEmpty() && sampleFrames.last().source.isEmpty()) {
+        QString source = line.trimmed();
+        if (!source.startsWith("??")) {
+            sampleFrames.last().source = source;
+        }
+    }
+}
+
+void ProfileManager::finishSample() {
+    if (sampleFrames.isEmpty()) return;
+
+    std::reverse(sampleFrames.begin(), sampleFrames.end());
+    callTree->addStack(sampleFrames);
+    sampleFrames.clear();
+}
+
+void ProfileManager::coloredOutputMessage(const QString& message, bool start) {
+    // Blue foreground
+    emit consoleMessage("\x1b[34m" + message + "\x1b[0m\n", start);
+}
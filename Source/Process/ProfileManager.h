@@ -0,0 +1,57 @@
+#pragma once
+#include "ProcessManager.h"
+#include "CallTree.h"
+#include <QSharedPointer>
+
+class ProjectProperties;
+
+// Profiles the run target with perf: builds it, records samples
+// and folds the output of perf script into a call tree.
+class ProfileManager : public ProcessManager {
+    Q_OBJECT
+public:
+    explicit ProfileManager(ProjectProperties* projectProperties, QObject* parent = nullptr);
+
+    static bool isAvailable();
+
+    void setProjectPath(const QString& path);
+    void profile();
+
+signals:
+    void consoleMessage(const QString& message, bool start = false);
+    void profileReady(QSharedPointer<CallTree> callTree);
+
+private slots:
+    void onReadyReadStandardOutput(ProcessJob* job, const QString& data) override;
+    void onReadyReadStandardError(ProcessJob* job, const QString& data) override;
+    void onFinished(ProcessJob* job, int exitCode, QProcess::ExitStatus exitStatus) override;
+    void onErrorOccurred(ProcessJob* job, QProcess::ProcessError error) override;
+
+private:
+    enum class Phase {
+        None,
+        Build,
+        Record,
+        Script
+    };
+
+    void startPhase(Phase phase, const QString& program, const QStringList& arguments);
+    void record();
+    void script();
+    void parseScriptLine(const QString& line);
+    void finishSample();
+    void coloredOutputMessage(const QString& message, bool start = false);
+
+    ProjectProperties* projectProperties;
+    QString projectPath;
+    QString binaryPath;
+    QString dataPath;
+
+    ProcessJob* currentJob = nullptr;
+    Phase phase = Phase::None;
+
+    QSharedPointer<CallTree> callTree;
+    QString scriptBuffer;
+    // Frames of the current sample, innermost first as perf prints them.
+    QVector<CallTree::Frame> sampleFrames;
+};
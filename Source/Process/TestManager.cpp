@@ -0,0 +1,434 @@
+#include "TestManager.h"
+#include "ProcessJob.h"
+#include "UI/ProjectProperties.h"
+#include "Core/Global.h"
+#include "Core/Preferences.h"
+#include <QtCore>
+#include <algorithm>
+
+// Keeps command lines of shards well below platform limits.
+static const int MAX_SHARD_ARGUMENTS_LENGTH = 24000;
+
+TestManager::TestManager(ProjectProperties* projectProperties, QObject* parent) :
+        ProcessManager(parent),
+        projectProperties(projectProperties) {
+}
+
+void TestManager::runAll() {
+    reset();
+    listedTests.clear();
+    failedTests.clear();
+    executables.clear();
+    hasDoctests = false;
+
+    // Compiler errors go to stderr as usual, artifacts of the test binaries to stdout.
+    QStringList arguments = getCargoArguments();
+    arguments << "--no-run" << "--message-format=json-render-diagnostics";
+    startPhase(Phase::Build, QString(), Global::getCargoPath(), arguments);
+}
+
+void TestManager::runFailed() {
+    reset();
+
+    QVector<Test> tests = failedTests;
+    failedTests.clear();
+    run(tests);
+}
+
+void TestManager::reset() {
+    stop();
+    shards.clear();
+    passed = 0;
+    failed = 0;
+    ignored = 0;
+    runTimer.start();
+}
+
+void TestManager::list() {
+    // The binaries are listed directly, only doctests need cargo to invoke rustdoc.
+    for (const Executable& executable : executables) {
+        startPhase(Phase::List, executable.target, executable.path,
+                QStringList() << "--list" << "--format" << "terse");
+    }
+
+    if (hasDoctests) {
+        startCargoTest("--doc", QStringList() << "--list" << "--format" << "terse", Phase::List);
+    }
+
+    if (shards.isEmpty()) {
+        emit testsListed(QVector<Test>());
+        emit runFinished(passed, failed, ignored, runTimer.elapsed());
+    }
+}
+
+void TestManager::run(const QVector<Test>& tests) {
+    if (tests.isEmpty()) {
+        emit runFinished(passed, failed, ignored, runTimer.elapsed());
+        return;
+    }
+
+    QMap<QString, QStringList> targets;
+    for (const Test& test : tests) {
+        targets[test.target].append(test.name);
+    }
+
+    // JSON output comes from libtest's own thread pool. Human output is parsed with
+    // one test thread per process, which makes per-test durations measurable.
+    jsonFormat = Preferences::getInstance()->getTest().jsonFormat;
+    int shardCount = qMin(getShardCount(), tests.count());
+    int testThreads = jsonFormat ? qMax(1, QThread::idealThreadCount() / shardCount) : 1;
+
+    for (auto it = targets.constBegin(); it != targets.constEnd(); ++it) {
+        const QStringList& names = it.value();
+
+        // Shards are shared out by the number of tests in the binary.
+        int count = qBound(1, (shardCount * names.count() + tests.count() - 1) / tests.count(), names.count());
+
+        // Round-robin keeps slow modules from landing in a single shard.
+        QVector<QStringList> groups(count);
+        for (int i = 0; i < names.count(); i++) {
+            groups[i % count].append(names.at(i));
+        }
+
+        for (const QStringList& group : groups) {
+            QStringList chunk;
+            int length = 0;
+
+            for (const QString& name : group) {
+                if (!chunk.isEmpty() && length + name.size() > MAX_SHARD_ARGUMENTS_LENGTH) {
+                    startShard(it.key(), chunk, testThreads);
+                    chunk.clear();
+                    length = 0;
+                }
+
+                chunk.append(name);
+                length += name.size() + 1;
+            }
+
+            if (!chunk.isEmpty()) {
+                startShard(it.key(), chunk, testThreads);
+            }
+        }
+    }
+}
+
+void TestManager::startShard(const QString& target, const QStringList& names, int testThreads) {
+    QStringList arguments;
+    if (jsonFormat) {
+        arguments << "-Z" << "unstable-options" << "--format" << "json" << "--report-time";
+    }
+
+    arguments << QString("--test-threads=%1").arg(testThreads);
+    arguments << "--exact";
+    arguments << names;
+
+    startCargoTest(target, arguments, Phase::Run);
+}
+
+void TestManager::startCargoTest(const QString& target, const QStringList& testArguments, Phase phase) {
+    QStringList arguments = getCargoArguments();
+    arguments << target.split(' ');
+    arguments << "--" << "--color" << "never";
+    arguments << testArguments;
+
+    startPhase(phase, target, Global::getCargoPath(), arguments);
+}
+
+void TestManager::startPhase(Phase phase, const QString& target, const QString& program, const QStringList& arguments) {
+    ProcessJob* job = createJob(program, arguments);
+    Shard shard;
+    shard.phase = phase;
+    shard.target = target;
+    shards[job] = shard;
+    startJob(job);
+}
+
+QStringList TestManager::getCargoArguments() const {
+    QStringList arguments;
+    arguments << "--color=always" << "test";
+    if (projectProperties->getBuildTarget() == CargoManager::BuildTarget::Release) {
+        arguments << "--release";
+    }
+
+    return arguments;
+}
+
+int TestManager::getShardCount() const {
+    int shardCount = Preferences::getInstance()->getTest().shards;
+    return shardCount > 0 ? shardCount : QThread::idealThreadCount();
+}
+
+void TestManager::onReadyReadStandardOutput(ProcessJob* job, const QString& data) {
+    auto it = shards.find(job);
+    if (it == shards.end()) return;
+
+    Shard& shard = it.value();
+    shard.buffer += data;
+
+    int begin = 0;
+    int end = shard.buffer.indexOf('\n');
+    while (end != -1) {
+        QString line = shard.buffer.mid(begin, end - begin);
+        if (line.endsWith('\r')) {
+            line.chop(1);
+        }
+
+        parseLine(shard, line);
+        begin = end + 1;
+        end = shard.buffer.indexOf('\n', begin);
+    }
+
+    shard.buffer.remove(0, begin);
+    parsePartialLine(shard);
+}
+
+void TestManager::onReadyReadStandardError(ProcessJob* job, const QString& data) {
+    auto it = shards.find(job);
+    if (it == shards.end()) return;
+
+    // Compiler output of the build and listing steps is shown right away,
+    // shards only report it if they fail without running anything.
+    if (it.value().phase != Phase::Run) {
+        emit consoleMessage(data);
+    } else {
+        it.value().errors += data;
+    }
+}
+
+void TestManager::onFinished(ProcessJob* job, int exitCode, QProcess::ExitStatus exitStatus) {
+    if (job->isCanceled() || !shards.contains(job)) return;
+
+    Shard shard = shards.take(job);
+
+    if (!shard.buffer.isEmpty()) {
+        parseLine(shard, shard.buffer);
+        shard.buffer.clear();
+    }
+
+    flushOutput(shard);
+
+    bool success = exitStatus == QProcess::NormalExit && exitCode == 0;
+
+    if (shard.phase == Phase::Build) {
+        if (success) {
+            list();
+        } else {
+            emit runFinished(passed, failed, ignored, runTimer.elapsed());
+        }
+
+        return;
+    }
+
+    if (shard.phase == Phase::List) {
+        if (!success) {
+            emit consoleMessage(tr("Failed to list tests of %1\n").arg(shard.target));
+        }
+
+        // Tests of the binaries that could be listed still run.
+        if (shards.isEmpty()) {
+            std::sort(listedTests.begin(), listedTests.end(), [] (const Test& a, const Test& b) {
+                return a.target != b.target ? a.target < b.target : a.name < b.name;
+            });
+
+            emit testsListed(listedTests);
+            run(listedTests);
+        }
+
+        return;
+    }
+
+    // The process died in the middle of a test (abort, stack overflow...).
+    if (!shard.runningTest.isEmpty()) {
+        finishTest(shard, shard.runningTest, Status::Failed, shard.runningTimer.elapsed());
+        shard.runningTest.clear();
+    }
+
+    if (!success && !shard.reported) {
+        emit consoleMessage(shard.errors);
+    }
+
+    if (shards.isEmpty()) {
+        emit runFinished(passed, failed, ignored, runTimer.elapsed());
+    }
+}
+
+void TestManager::parseLine(Shard& shard, const QString& line) {
+    if (shard.phase == Phase::Build) {
+        parseArtifactLine(line);
+    } else if (shard.phase == Phase::List) {
+        const QString suffix = ": test";
+        if (line.endsWith(suffix)) {
+            Test test;
+            test.target = shard.target;
+            test.name = line.left(line.size() - suffix.size());
+            listedTests.append(test);
+        }
+    } else if (jsonFormat) {
+        parseJsonLine(shard, line);
+    } else {
+        parseHumanLine(shard, line);
+    }
+}
+
+void TestManager::parseArtifactLine(const QString& line) {
+    if (!line.startsWith('{')) return;
+
+    QJsonObject obj = QJsonDocument::fromJson(line.toUtf8()).object();
+    if (obj["reason"].toString() != "compiler-artifact") return;
+    if (!obj["profile"].toObject()["test"].toBool()) return;
+
+    QString path = obj["executable"].toString();
+    if (path.isEmpty()) return;
+
+    // Libraries have kinds like "lib", "rlib" or "proc-macro".
+    QJsonObject target = obj["target"].toObject();
+    QString kind = target["kind"].toArray().at(0).toString();
+    QString name = target["name"].toString();
+
+    Executable executable;
+    executable.path = path;
+
+    if (kind == "bin" || kind == "test" || kind == "bench" || kind == "example") {
+        executable.target = QString("--%1 %2").arg(kind, name);
+    } else {
+        executable.target = "--lib";
+        hasDoctests = hasDoctests || target["doctest"].toBool(true);
+    }
+
+    executables.append(executable);
+}
+
+void TestManager::parseJsonLine(Shard& shard, const QString& line) {
+    if (!line.startsWith('{')) return;
+
+    QJsonObject obj = QJsonDocument::fromJson(line.toUtf8()).object();
+    if (obj["type"].toString() != "test") return;
+
+    QString name = obj["name"].toString();
+    QString event = obj["event"].toString();
+
+    if (event == "started") {
+        emit testStarted(shard.target, name);
+        return;
+    }
+
+    Status status;
+    if (event == "ok") {
+        status = Status::Passed;
+    } else if (event == "failed") {
+        status = Status::Failed;
+    } else if (event == "ignored") {
+        status = Status::Ignored;
+    } else {
+        return;
+    }
+
+    // Seconds, formatted as "0.001s" by older toolchains.
+    qint64 duration = -1;
+    QJsonValue execTime = obj["exec_time"];
+    if (execTime.isDouble()) {
+        duration = qRound64(execTime.toDouble() * 1000);
+    } else if (execTime.isString()) {
+        QString value = execTime.toString();
+        value.chop(1);
+        duration = qRound64(value.toDouble() * 1000);
+    }
+
+    finishTest(shard, name, status, duration);
+
+    if (obj.contains("stdout")) {
+        emit testOutput(shard.target, name, obj["stdout"].toString());
+    }
+}
+
+void TestManager::parseHumanLine(Shard& shard, const QString& line) {
+    // test path::to::name ... ok
+    int separator = line.lastIndexOf(" ... ");
+    if (line.startsWith("test ") && separator > 5) {
+        QString name = line.mid(5, separator - 5);
+        QString result = line.mid(separator + 5);
+
+        Status status;
+        if (result == "ok") {
+            status = Status::Passed;
+        } else if (result.startsWith("FAILED")) {
+            status = Status::Failed;
+        } else if (result.startsWith("ignored")) {
+            status = Status::Ignored;
+        } else {
+            return;
+        }
+
+        qint64 duration = -1;
+        if (shard.runningTest == name) {
+            duration = shard.runningTimer.elapsed();
+            shard.runningTest.clear();
+        }
+
+        finishTest(shard, name, status, duration);
+        return;
+    }
+
+    // Captured output of failed tests:
+    // ---- path::to::name stdout ----
+    const QString header = "---- ";
+    const QString footer = " stdout ----";
+    if (line.startsWith(header) && line.endsWith(footer)) {
+        flushOutput(shard);
+        shard.outputTest = line.mid(header.size(), line.size() - header.size() - footer.size());
+        return;
+    }
+
+    if (shard.outputTest.isEmpty()) return;
+
+    if (line == "failures:" || line.startsWith("test result:")) {
+        flushOutput(shard);
+    } else {
+        shard.output += line + '\n';
+    }
+}
+
+void TestManager::parsePartialLine(Shard& shard) {
+    if (jsonFormat || shard.phase != Phase::Run) return;
+
+    // With a single test thread libtest prints the name before running the test.
+    const QString& buffer = shard.buffer;
+    if (buffer.startsWith("test ") && buffer.endsWith(" ... ")) {
+        QString name = buffer.mid(5, buffer.size() - 10);
+        if (shard.runningTest != name) {
+            shard.runningTest = name;
+            shard.runningTimer.start();
+            emit testStarted(shard.target, name);
+        }
+    }
+}
+
+void TestManager::finishTest(Shard& shard, const QString& name, Status status, qint64 duration) {
+    shard.reported = true;
+
+    switch (status) {
+        case Status::Passed:
+            passed++;
+            break;
+        case Status::Failed:
+            failed++;
+            failedTests.append({ shard.target, name });
+            break;
+        case Status::Ignored:
+            ignored++;
+            break;
+        default:
+            break;
+    }
+
+    emit testFinished(shard.target, name, status, duration);
+}
+
+void TestManager::flushOutput(Shard& shard) {
+    if (!shard.outputTest.isEmpty()) {
+        emit testOutput(shard.target, shard.outputTest, shard.output.trimmed());
+    }
+
+    shard.outputTest.clear();
+    shard.output.clear();
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "ProcessManager.h"
+#include <QHash>
+#include <QVector>
+#include <QElapsedTimer>
+
+class ProjectProperties;
+
+// Builds the test binaries once, lists their tests and runs them sharded across
+// several processes, reporting results as soon as libtest prints them.
+// Every shard selects a single test target, so cargo only launches that binary.
+class TestManager : public ProcessManager {
+    Q_OBJECT
+public:
+    enum class Status {
+        Pending,
+        Running,
+        Passed,
+        Failed,
+        Ignored
+    };
+
+    // Target is the cargo selector of the test binary, e.g. "--lib" or "--test name".
+    // Names are only unique within a target, the lib and a bin may both have tests::it_works.
+    struct Test {
+        QString target;
+        QString name;
+    };
+
+    explicit TestManager(ProjectProperties* projectProperties, QObject* parent = nullptr);
+
+    void runAll();
+    void runFailed();
+    bool hasFailedTests() const { return !failedTests.isEmpty(); }
+
+signals:
+    void consoleMessage(const QString& message, bool start = false);
+    void testsListed(const QVector<TestManager::Test>& tests);
+    void testStarted(const QString& target, const QString& name);
+    void testFinished(const QString& target, const QString& name, TestManager::Status status, qint64 duration);
+    void testOutput(const QString& target, const QString& name, const QString& output);
+    void runFinished(int passed, int failed, int ignored, qint64 elapsed);
+
+private slots:
+    void onReadyReadStandardOutput(ProcessJob* job, const QString& data) override;
+    void onReadyReadStandardError(ProcessJob* job, const QString& data) override;
+    void onFinished(ProcessJob* job, int exitCode, QProcess::ExitStatus exitStatus) override;
+
+private:
+    enum class Phase {
+        Build,
+        List,
+        Run
+    };
+
+    struct Executable {
+        QString target;
+        QString path;
+    };
+
+    struct Shard {
+        Phase phase = Phase::Run;
+        QString target;
+        QString buffer;
+        QString runningTest;
+        QElapsedTimer runningTimer;
+        QString outputTest;
+        QString output;
+        QString errors;
+        bool reported = false;
+    };
+
+    void reset();
+    void list();
+    void run(const QVector<Test>& tests);
+    void startShard(const QString& target, const QStringList& names, int testThreads);
+    void startCargoTest(const QString& target, const QStringList& testArguments, Phase phase);
+    void startPhase(Phase phase, const QString& target, const QString& program, const QStringList& arguments);
+    QStringList getCargoArguments() const;
+    int getShardCount() const;
+
+    void parseLine(Shard& shard, const QString& line);
+    void parseArtifactLine(const QString& line);
+    void parseJsonLine(Shard& shard, const QString& line);
+    void parseHumanLine(Shard& shard, const QString& line);
+    void parsePartialLine(Shard& shard);
+    void finishTest(Shard& shard, const QString& name, Status status, qint64 duration);
+    void flushOutput(Shard& shard);
+
+    ProjectProperties* projectProperties;
+    QHash<ProcessJob*, Shard> shards;
+    QVector<Executable> executables;
+    bool hasDoctests = false;
+    QVector<Test> listedTests;
+    QVector<Test> failedTests;
+    bool jsonFormat = false;
+    int passed = 0;
+    int failed = 0;
+    int ignored = 0;
+    QElapsedTimer runTimer;
+};
@@ -0,0 +1,139 @@
+#include "DocumentRegistry.h"
+#include "TextEditor.h"
+#include "Highlighter.h"
+#include "Core/Trace.h"
+#include <QtWidgets>
+
+DocumentRegistry::DocumentRegistry(QObject* parent) : QObject(parent) {
+
+}
+
+QString DocumentRegistry::toKey(const QString& filePath) {
+    QFileInfo fi(filePath);
+    // Files that don't exist yet have no canonical path.
+    QString canonicalPath = fi.canonicalFilePath();
+    return canonicalPath.isEmpty() ? QDir::cleanPath(fi.absoluteFilePath()) : canonicalPath;
+}
+
+QTextDocument* DocumentRegistry::acquire(TextEditor* view) {
+    view->documentKey = toKey(view->getFilePath());
+    Document& document = documents[view->documentKey];
+
+    if (!document.textDocument) {
+        document.filePath = view->getFilePath();
+        document.textDocument = new QTextDocument(this);
+        document.textDocument->setDocumentLayout(new QPlainTextDocumentLayout(document.textDocument));
+    }
+
+    document.views.append(view);
+    return document.textDocument;
+}
+
+void DocumentRegistry::release(TextEditor* view) {
+    auto it = documents.find(view->documentKey);
+    if (it == documents.end()) return;
+
+    it->views.removeOne(view);
+
+    if (it->views.isEmpty()) {
+        // The view's base class is still being destroyed.
+        it->textDocument->deleteLater();
+        documents.erase(it);
+    }
+}
+
+QVector<TextEditor*> DocumentRegistry::getViews(const QString& filePath) const {
+    return documents.value(toKey(filePath)).views;
+}
+
+QVector<TextEditor*> DocumentRegistry::getViews(TextEditor* view) const {
+    return documents.value(view->documentKey).views;
+}
+
+void DocumentRegistry::rename(TextEditor* view, const QString& newPath) {
+    // The old path is gone from disk, so the key can't be computed from it again.
+    if (!documents.contains(view->documentKey)) return;
+
+    Document document = documents.take(view->documentKey);
+    document.filePath = newPath;
+    QString newKey = toKey(newPath);
+
+    for (TextEditor* documentView : document.views) {
+        documentView->filePath = newPath;
+        documentView->documentKey = newKey;
+    }
+
+    documents.insert(newKey, document);
+}
+
+void DocumentRegistry::load(TextEditor* view) {
+    auto it = documents.find(view->documentKey);
+    if (it == documents.end() || it->loaded) return;
+
+    TRACE_SCOPE("DocumentRegistry::load");
+    it->loaded = true;
+    QString filePath = it->filePath;
+
+    QFileInfo fi(filePath);
+    if (Highlighter::hasExtension(fi.suffix())) {
+        it->highlighter = new Highlighter(fi.suffix(), it->textDocument);
+    }
+
+    QFile file(filePath);
+    if (file.open(QFile::ReadOnly | QFile::Text)) {
+        it->textDocument->setPlainText(file.readAll());
+        it->textDocument->setModified(false);
+    } else {
+        qWarning() << "Failed to open file for reading" << filePath;
+    }
+}
+
+bool DocumentRegistry::unload(TextEditor* view) {
+    auto it = documents.find(view->documentKey);
+    if (it == documents.end() || !it->loaded || it->textDocument->isModified()) return false;
+
+    // Clearing the text would drop the undo history of edits that were saved since.
+    if (it->textDocument->isUndoAvailable() || it->textDocument->isRedoAvailable()) return false;
+
+    for (TextEditor* documentView : it->views) {
+        if (documentView->isVisible()) return false;
+    }
+
+    for (TextEditor* documentView : it->views) {
+        documentView->pendingCursorPosition = documentView->getCursorPosition();
+        documentView->pendingScrollPosition = documentView->getScrollPosition();
+        documentView->loaded = false;
+    }
+
+    it->loaded = false;
+
+    delete it->highlighter;
+    it->highlighter = nullptr;
+
+    // The undo stack is empty, it only ever refers to the text.
+    it->textDocument->clear();
+    it->textDocument->setModified(false);
+
+    return true;
+}
+
+qint64 DocumentRegistry::getMemoryUsage(TextEditor* view) const {
+    auto it = documents.constFind(view->documentKey);
+    return it == documents.constEnd() ? 0 : getMemoryUsage(*it);
+}
+
+qint64 DocumentRegistry::getMemoryUsage() const {
+    qint64 usage = 0;
+    for (const Document& document : documents) {
+        usage += getMemoryUsage(document);
+    }
+
+    return usage;
+}
+
+qint64 DocumentRegistry::getMemoryUsage(const Document& document) {
+    if (!document.loaded) return 0;
+
+    // UTF-16 text, about as much again for line layouts and highlight formats.
+    return qint64(document.textDocument->characterCount()) * sizeof(QChar) * 2;
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "Core/Singleton.h"
+#include <QObject>
+#include <QHash>
+#include <QVector>
+
+class QTextDocument;
+class Highlighter;
+class TextEditor;
+
+// Open documents by canonical file path. All editors of a file, e.g. a tab and
+// a split view, share one QTextDocument and one highlighter, so the text is
+// held and highlighted once and edits show in every view.
+class DocumentRegistry : public QObject, public Singleton<DocumentRegistry> {
+    Q_OBJECT
+
+public:
+    explicit DocumentRegistry(QObject* parent = nullptr);
+
+    static QString toKey(const QString& filePath);
+
+    // Returns the document of the file, created empty for the first view.
+    QTextDocument* acquire(TextEditor* view);
+    // The document is deleted with its last view.
+    void release(TextEditor* view);
+
+    QVector<TextEditor*> getViews(const QString& filePath) const;
+    // All views of the view's document, without touching the file system.
+    QVector<TextEditor*> getViews(TextEditor* view) const;
+    // Moves the document and all its views to the new path.
+    void rename(TextEditor* view, const QString& newPath);
+
+    // Reads the file into the document once, for all views.
+    void load(TextEditor* view);
+    // Drops the text of an unmodified document that no view shows.
+    bool unload(TextEditor* view);
+
+    // Rough size of the loaded text with its layouts and highlighting.
+    qint64 getMemoryUsage(TextEditor* view) const;
+    qint64 getMemoryUsage() const;
+
+private:
+    struct Document {
+        QString filePath;
+        QTextDocument* textDocument = nullptr;
+        Highlighter* highlighter = nullptr;
+        QVector<TextEditor*> views;
+        bool loaded = false;
+    };
+
+    static qint64 getMemoryUsage(const Document& document);
+
+    QHash<QString, Document> documents;
+};
@@ -1,8 +1,10 @@
 #include "Highlighter.h"
 #include "SyntaxHighlightManager.h"
+#include "Core/Trace.h"
 #include <QtCore>
 
 Highlighter::Highlighter(const QString& fileExt, QTextDocument* parent) : QSyntaxHighlighter(parent) {
+    TRACE_SCOPE("Highlighter::Highlighter");
     loadRules(fileExt);
 }
 
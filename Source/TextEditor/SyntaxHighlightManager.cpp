@@ -1,7 +1,9 @@
 #include "SyntaxHighlightManager.h"
+#include "Core/Trace.h"
 #include <QtCore>
 
 SyntaxHighlightManager::SyntaxHighlightManager(QObject* parent) : QObject(parent) {
+    TRACE_SCOPE("SyntaxHighlightManager::SyntaxHighlightManager");
     addSyntaxFile(":/Resources/Highlighting/Rust.json");
 }
 
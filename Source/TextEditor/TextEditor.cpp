@@ -1,30 +1,26 @@
 #include "TextEditor.h"
 #include "LineNumberArea.h"
-#include "Highlighter.h"
+#include "DocumentRegistry.h"
 #include "AutoCompleter.h"
-#include "Core/Settings.h"
+#include "Core/Preferences.h"
 #include "Core/Constants.h"
+#include "Core/Trace.h"
 #include <QtWidgets>
 
 TextEditor::TextEditor(QString filePath, QWidget* parent) :
         QPlainTextEdit(parent),
-        filePath(filePath) {
+        filePath(filePath),
+        lastActive(QDateTime::currentMSecsSinceEpoch()) {
+    setDocument(DocumentRegistry::getInstance()->acquire(this));
     setFrameShape(QFrame::NoFrame);
 
-    const QString& family = Settings::getValue("editor.font.family").toString();
-    int size = Settings::getValue("editor.font.size").toInt();
-    QFont font(family, size);
-    document()->setDefaultFont(font);
+    applyPreferences();
+    connect(Preferences::getInstance(), &Preferences::editorChanged, this, &TextEditor::applyPreferences);
 
     setWordWrapMode(QTextOption::NoWrap);
 
     lineNumberArea = new LineNumberArea(this);
 
-    QFileInfo fi(filePath);
-    if (Highlighter::hasExtension(fi.suffix())) {
-        highlighter = new Highlighter(fi.suffix(), document());
-    }
-
     connect(this, &TextEditor::blockCountChanged, this, &TextEditor::updateLineNumberAreaWidth);
     connect(this, &TextEditor::updateRequest, this, &TextEditor::updateLineNumberArea);
     connect(this, &TextEditor::cursorPositionChanged, this, &TextEditor::highlightCurrentLine);
@@ -35,11 +31,38 @@ TextEditor::TextEditor(QString filePath, QWidget* parent) :
     connect(this, &TextEditor::textChanged, [this] {
         emit documentModified(this);
     });
+}
+
+TextEditor::~TextEditor() {
+    DocumentRegistry::getInstance()->release(this);
+}
+
+void TextEditor::load() {
+    if (loaded) return;
+    loaded = true;
+
+    DocumentRegistry::getInstance()->load(this);
+
+    setCursorPosition(pendingCursorPosition);
+    setScrollPosition(pendingScrollPosition);
+}
 
-    readFile();
+bool TextEditor::unload() {
+    return DocumentRegistry::getInstance()->unload(this);
+}
+
+void TextEditor::applyPreferences() {
+    const Preferences::Editor& editor = Preferences::getInstance()->getEditor();
+    document()->setDefaultFont(QFont(editor.fontFamily, editor.fontSize));
+
+    if (lineNumberArea) {
+        updateLineNumberAreaWidth(0);
+    }
 }
 
 void TextEditor::setFilePath(const QString& filePath) {
+    // Renames all views of the document.
+    DocumentRegistry::getInstance()->rename(this, filePath);
     this->filePath = filePath;
 }
 
@@ -53,7 +76,9 @@ void TextEditor::setAutoCompleter(AutoCompleter* completer) {
 void TextEditor::saveFile() {
     if (!document()->isModified()) return;
 
-    if (Settings::getValue("editor.cleanTrailingWhitespaceOnSave").toBool()) {
+    TRACE_SCOPE("TextEditor::saveFile");
+
+    if (Preferences::getInstance()->getEditor().cleanTrailingWhitespaceOnSave) {
        cleanTrailingWhitespace();
     }
 
@@ -63,6 +88,7 @@ void TextEditor::saveFile() {
         out << toPlainText();
         document()->setModified(false);
         documentModified(this);
+        emit fileSaved(this);
     } else {
         qWarning() << "Failed to open file for writing" << filePath;
     }
@@ -74,17 +100,37 @@ QString TextEditor::getModifiedName() const {
 }
 
 QPoint TextEditor::getCursorPosition() {
+    if (!loaded) return pendingCursorPosition;
+
     QTextCursor cursor = textCursor();
     return QPoint(cursor.positionInBlock(), cursor.blockNumber());
 }
 
 void TextEditor::setCursorPosition(const QPoint& pos) {
+    if (!loaded) {
+        pendingCursorPosition = pos;
+        return;
+    }
+
     QTextCursor cursor = textCursor();
     cursor.movePosition(QTextCursor::NextBlock, QTextCursor::MoveAnchor, pos.y());
     cursor.movePosition(QTextCursor::NextCharacter, QTextCursor::MoveAnchor, pos.x());
     setTextCursor(cursor);
 }
 
+int TextEditor::getScrollPosition() const {
+    return loaded ? verticalScrollBar()->value() : pendingScrollPosition;
+}
+
+void TextEditor::setScrollPosition(int line) {
+    if (!loaded) {
+        pendingScrollPosition = line;
+        return;
+    }
+
+    verticalScrollBar()->setValue(line);
+}
+
 void TextEditor::lineNumberAreaPaintEvent(QPaintEvent* event) {
     QPainter painter(lineNumberArea);
     painter.fillRect(event->rect(), QColor(240, 240, 240));
@@ -117,7 +163,7 @@ int TextEditor::getLineNumberAreaWidth() {
         ++digits;
     }
 
-    digits = qMax(Settings::getValue("editor.numberAreaDigits").toInt(), digits);
+    digits = qMax(Preferences::getInstance()->getEditor().numberAreaDigits, digits);
     int space = 3 + fontMetrics().width(QLatin1Char('9')) * digits;
 
     return space;
@@ -329,7 +375,7 @@ void TextEditor::increaseIndent() {
 
     cursor.beginEditBlock();
 
-    int indent = Settings::getValue("editor.indent").toInt();
+    int indent = Preferences::getInstance()->getEditor().indent;
 
     for (int row = startRow; row <= endRow; row++) {
         QTextBlock block = document()->findBlockByLineNumber(row);
@@ -366,7 +412,7 @@ void TextEditor::decreaseIndent() {
 
     cursor.beginEditBlock();
 
-    int indent = Settings::getValue("editor.indent").toInt();
+    int indent = Preferences::getInstance()->getEditor().indent;
 
     for (int row = startRow; row <= endRow; row++) {
         QTextBlock block = document()->findBlockByLineNumber(row);
@@ -396,11 +442,13 @@ void TextEditor::decreaseIndent() {
     cursor.endEditBlock();
 }
 
-void TextEditor::goToLine(int line) {
+void TextEditor::goToLine(int line, int column) {
+    load();
+
     int row =  qMin(qMax(0, line - 1), blockCount() - 1);
     QTextBlock block = document()->findBlockByLineNumber(row);
     QTextCursor cursor = textCursor();
-    cursor.setPosition(block.position());
+    cursor.setPosition(block.position() + qMin(qMax(0, column - 1), block.length() - 1));
     setTextCursor(cursor);
 }
 
@@ -454,6 +502,17 @@ void TextEditor::resizeEvent(QResizeEvent* event) {
     lineNumberArea->setGeometry(QRect(cr.left(), cr.top(), getLineNumberAreaWidth(), cr.height()));
 }
 
+void TextEditor::showEvent(QShowEvent* event) {
+    lastActive = QDateTime::currentMSecsSinceEpoch();
+    load();
+    QPlainTextEdit::showEvent(event);
+}
+
+void TextEditor::hideEvent(QHideEvent* event) {
+    lastActive = QDateTime::currentMSecsSinceEpoch();
+    QPlainTextEdit::hideEvent(event);
+}
+
 void TextEditor::focusInEvent(QFocusEvent* event) {
     focusChanged(event->gotFocus());
     QPlainTextEdit::focusInEvent(event);
@@ -499,15 +558,6 @@ void TextEditor::updateLineNumberArea(const QRect& rect, int dy) {
     }
 }
 
-void TextEditor::readFile() {
-    QFile file(filePath);
-    if (file.open(QFile::ReadOnly | QFile::Text)) {
-        setPlainText(file.readAll());
-    } else {
-        qWarning() << "Failed to open file for reading" << filePath;
-    }
-}
-
 QString TextEditor::textUnderCursor() const {
     QTextCursor cursor = textCursor();
     cursor.select(QTextCursor::WordUnderCursor);
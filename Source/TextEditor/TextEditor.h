@@ -2,13 +2,23 @@
 #include <QPlainTextEdit>
 #include <QPoint>
 
-class Highlighter;
 class AutoCompleter;
 
 class TextEditor : public QPlainTextEdit {
     Q_OBJECT
 public:
+    // The file is read when the editor is first shown, so background tabs stay cheap.
+    // Editors of the same file share their document, see DocumentRegistry.
     explicit TextEditor(QString filePath, QWidget* parent = nullptr);
+    ~TextEditor();
+
+    bool isLoaded() const { return loaded; }
+    void load();
+    // Drops the text of an unmodified document that no editor shows, keeping the
+    // path and positions. Documents with undo history are kept. Returns whether it was unloaded.
+    bool unload();
+    // Time of the last show or hide, in milliseconds since the epoch.
+    qint64 getLastActive() const { return lastActive; }
 
     QString getFilePath() const { return filePath; }
     void setFilePath(const QString& filePath);
@@ -21,6 +31,9 @@ public:
 
     QPoint getCursorPosition();
     void setCursorPosition(const QPoint& pos);
+    // First visible line.
+    int getScrollPosition() const;
+    void setScrollPosition(int line);
 
     void lineNumberAreaPaintEvent(QPaintEvent *event);
     int getLineNumberAreaWidth();
@@ -39,31 +52,42 @@ public:
     void toggleBlockComment();
 
     void openAutoCompleter();
-    void goToLine(int line);
+    void goToLine(int line, int column = 1);
     void cleanTrailingWhitespace();
 
 signals:
     void documentModified(TextEditor* editor);
+    void fileSaved(TextEditor* editor);
     void focusChanged(bool focus);
 
 protected:
     void keyPressEvent(QKeyEvent* event) override;
     void resizeEvent(QResizeEvent *event) override;
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
     void focusInEvent(QFocusEvent* event) override;
     void focusOutEvent(QFocusEvent* event) override;
 
 private slots:
+    void applyPreferences();
     void updateLineNumberAreaWidth(int newBlockCount);
     void highlightCurrentLine();
     void updateLineNumberArea(const QRect &rect, int dy);
 
 private:
-    void readFile();
+    friend class DocumentRegistry;
+
     void autoindent();
     void extendSelectionToBeginOfComment();
 
-    QWidget* lineNumberArea;
-    Highlighter* highlighter;
+    QWidget* lineNumberArea = nullptr;
     QString filePath;
-    AutoCompleter* completer;
+    QString documentKey;
+    AutoCompleter* completer = nullptr;
+
+    bool loaded = false;
+    // Positions set before loading, applied once the text is there.
+    QPoint pendingCursorPosition;
+    int pendingScrollPosition = 0;
+    qint64 lastActive = 0;
 };
@@ -0,0 +1,229 @@
+#include "AnsiEscapeParser.h"
+#include <QtGui>
+
+static const ushort ESCAPE = 0x1b;
+static const ushort BELL = 0x07;
+
+// SGR parameters are small, longer digit runs are clamped.
+static const int MAX_SGR_PARAMETER = 9999;
+
+// Longer unterminated sequences are treated as garbage and dropped.
+static const int MAX_ESCAPE_LENGTH = 64;
+
+// Colors tuned for a light background.
+static const QRgb PALETTE[16] = {
+    0x000000, 0xcd3131, 0x00bc00, 0x949800, 0x0451a5, 0xbc05bc, 0x0598bc, 0x555555,
+    0x666666, 0xcd3131, 0x14ce14, 0xb5ba00, 0x0451a5, 0xbc05bc, 0x0598bc, 0xa5a5a5
+};
+
+void AnsiEscapeParser::parse(const QString& input, QVector<Run>& runs) {
+    QString buffer;
+    const QChar* p = input.constData();
+    const QChar* end = p + input.size();
+
+    if (!pendingEscape.isEmpty()) {
+        buffer = pendingEscape + input;
+        pendingEscape.clear();
+        p = buffer.constData();
+        end = p + buffer.size();
+    }
+
+    if (inOsc) {
+        p = skipOsc(p, end);
+        if (inOsc) return;
+    }
+
+    const QChar* textBegin = p;
+
+    while (p < end) {
+        if (p->unicode() != ESCAPE) {
+            ++p;
+            continue;
+        }
+
+        appendText(textBegin, p, runs);
+
+        const QChar* sequence = p;
+        if (sequence + 1 == end) {
+            pendingEscape = QString(sequence, 1);
+            return;
+        }
+
+        if (sequence[1] == QLatin1Char(']')) {
+            // Operating system command, the payload may span chunks.
+            inOsc = true;
+            p = skipOsc(sequence + 2, end);
+            if (inOsc) return;
+
+            textBegin = p;
+            continue;
+        }
+
+        if (sequence[1] != QLatin1Char('[')) {
+            // Two-character escape, not a control sequence.
+            p = sequence + 2;
+            textBegin = p;
+            continue;
+        }
+
+        // Control sequence: parameter and intermediate bytes until a final byte in 0x40..0x7E.
+        const QChar* q = sequence + 2;
+        while (q < end && (q->unicode() < 0x40 || q->unicode() > 0x7e)) {
+            ++q;
+        }
+
+        if (q == end) {
+            if (end - sequence < MAX_ESCAPE_LENGTH) {
+                pendingEscape = QString(sequence, static_cast<int>(end - sequence));
+            }
+            return;
+        }
+
+        if (*q == QLatin1Char('m')) {
+            applySgr(sequence + 2, q);
+        }
+
+        p = q + 1;
+        textBegin = p;
+    }
+
+    appendText(textBegin, end, runs);
+}
+
+void AnsiEscapeParser::reset() {
+    pendingEscape.clear();
+    inOsc = false;
+    format = QTextCharFormat();
+}
+
+const QChar* AnsiEscapeParser::skipOsc(const QChar* p, const QChar* end) {
+    while (p < end) {
+        ushort c = p->unicode();
+        if (c == BELL) {
+            inOsc = false;
+            return p + 1;
+        }
+
+        if (c == ESCAPE) {
+            // The escape of ESC \ may be the last character of the chunk.
+            if (p + 1 == end) {
+                pendingEscape = QString(p, 1);
+                return end;
+            }
+
+            if (p[1] == QLatin1Char('\\')) {
+                inOsc = false;
+                return p + 2;
+            }
+        }
+
+        ++p;
+    }
+
+    return end;
+}
+
+void AnsiEscapeParser::appendText(const QChar* begin, const QChar* end, QVector<Run>& runs) {
+    if (begin == end) return;
+
+    int size = static_cast<int>(end - begin);
+
+    if (!runs.isEmpty() && runs.last().format == format) {
+        runs.last().text.append(begin, size);
+    } else {
+        Run run;
+        run.text = QString(begin, size);
+        run.format = format;
+        runs.append(run);
+    }
+}
+
+void AnsiEscapeParser::applySgr(const QChar* begin, const QChar* end) {
+    QVarLengthArray<int, 16> params;
+    int value = 0;
+
+    for (const QChar* p = begin; p < end; ++p) {
+        ushort c = p->unicode();
+        if (c >= '0' && c <= '9') {
+            if (value <= MAX_SGR_PARAMETER) {
+                value = value * 10 + (c - '0');
+            }
+        } else if (c == ';' || c == ':') {
+            params.append(value);
+            value = 0;
+        }
+    }
+
+    params.append(value);
+
+    for (int i = 0; i < params.size(); i++) {
+        int code = params[i];
+
+        if (code == 0) {
+            format = QTextCharFormat();
+        } else if (code == 1) {
+            format.setFontWeight(QFont::Bold);
+        } else if (code == 3) {
+            format.setFontItalic(true);
+        } else if (code == 4) {
+            format.setFontUnderline(true);
+        } else if (code == 22) {
+            format.setFontWeight(QFont::Normal);
+        } else if (code == 23) {
+            format.setFontItalic(false);
+        } else if (code == 24) {
+            format.setFontUnderline(false);
+        } else if (code >= 30 && code <= 37) {
+            format.setForeground(paletteColor(code - 30));
+        } else if (code == 39) {
+            format.clearForeground();
+        } else if (code >= 40 && code <= 47) {
+            format.setBackground(paletteColor(code - 40));
+        } else if (code == 49) {
+            format.clearBackground();
+        } else if (code >= 90 && code <= 97) {
+            format.setForeground(paletteColor(code - 90 + 8));
+        } else if (code >= 100 && code <= 107) {
+            format.setBackground(paletteColor(code - 100 + 8));
+        } else if (code == 38 || code == 48) {
+            // Extended color: 5;index or 2;r;g;b
+            QColor color;
+            if (i + 2 < params.size() && params[i + 1] == 5) {
+                color = paletteColor(params[i + 2]);
+                i += 2;
+            } else if (i + 4 < params.size() && params[i + 1] == 2) {
+                color = QColor(qBound(0, params[i + 2], 255), qBound(0, params[i + 3], 255), qBound(0, params[i + 4], 255));
+                i += 4;
+            } else {
+                break;
+            }
+
+            if (code == 38) {
+                format.setForeground(color);
+            } else {
+                format.setBackground(color);
+            }
+        }
+    }
+}
+
+QColor AnsiEscapeParser::paletteColor(int index) {
+    if (index < 0 || index > 255) {
+        return QColor();
+    }
+
+    if (index < 16) {
+        return QColor(PALETTE[index]);
+    }
+
+    if (index < 232) {
+        // 6x6x6 color cube
+        static const int levels[6] = { 0, 95, 135, 175, 215, 255 };
+        int i = index - 16;
+        return QColor(levels[i / 36], levels[(i / 6) % 6], levels[i % 6]);
+    }
+
+    // Grayscale ramp
+    int gray = 8 + (index - 232) * 10;
+    return QColor(gray, gray, gray);
+}
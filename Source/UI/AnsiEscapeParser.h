@@ -0,0 +1,31 @@
+#pragma once
+#include <QString>
+#include <QVector>
+#include <QTextCharFormat>
+
+// Streaming parser for ANSI SGR escape sequences. Sequences split between
+// chunks are kept until the rest arrives. Non-SGR sequences are dropped,
+// as are OSC strings such as window titles and hyperlinks.
+class AnsiEscapeParser {
+
+public:
+    struct Run {
+        QString text;
+        QTextCharFormat format;
+    };
+
+    void parse(const QString& input, QVector<Run>& runs);
+    void reset();
+
+private:
+    void appendText(const QChar* begin, const QChar* end, QVector<Run>& runs);
+    // Returns the position after the string terminator, or end if the string goes on.
+    const QChar* skipOsc(const QChar* p, const QChar* end);
+    void applySgr(const QChar* begin, const QChar* end);
+    static QColor paletteColor(int index);
+
+    QString pendingEscape;
+    // Inside an OSC string, which ends with BEL or ESC \.
+    bool inOsc = false;
+    QTextCharFormat format;
+};
@@ -0,0 +1,194 @@
+#include "BenchmarkModel.h"
+#include <QtGui>
+
+// Changes within this ratio are reported as noise, same as Criterion's default.
+static const double NOISE_THRESHOLD = 0.02;
+// Benchmark ids are <group>/<function>/<parameter> at most.
+static const int MAX_ID_DEPTH = 3;
+
+static QString formatTime(double nanoseconds) {
+    if (nanoseconds < 1e3) return QString("%1 ns").arg(nanoseconds, 0, 'f', 2);
+    if (nanoseconds < 1e6) return QString("%1 µs").arg(nanoseconds / 1e3, 0, 'f', 2);
+    if (nanoseconds < 1e9) return QString("%1 ms").arg(nanoseconds / 1e6, 0, 'f', 2);
+    return QString("%1 s").arg(nanoseconds / 1e9, 0, 'f', 2);
+}
+
+static QString formatPercent(double ratio) {
+    return QString("%1%2%").arg(ratio > 0 ? "+" : "").arg(ratio * 100, 0, 'f', 2);
+}
+
+BenchmarkModel::BenchmarkModel(QObject* parent) : QAbstractTableModel(parent) {
+}
+
+void BenchmarkModel::setCriterionPath(const QString& path) {
+    beginResetModel();
+    benchmarks.clear();
+
+    findBenchmarks(path, QString(), 1);
+
+    endResetModel();
+}
+
+void BenchmarkModel::findBenchmarks(const QString& path, const QString& name, int depth) {
+    // Every benchmark id has its latest sample in <id>/new/estimates.json.
+    // Only the id levels are listed, the sample and report directories below are not.
+    QDir dir(path);
+    for (const QString& entry : dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name)) {
+        if (entry == "report") continue;
+
+        QString entryPath = dir.filePath(entry);
+        QString entryName = name.isEmpty() ? entry : name + "/" + entry;
+
+        if (QFileInfo::exists(entryPath + "/new/estimates.json")) {
+            Benchmark benchmark;
+            benchmark.name = entryName;
+            benchmark.path = entryPath;
+            benchmarks.append(benchmark);
+        } else if (depth < MAX_ID_DEPTH) {
+            findBenchmarks(entryPath, entryName, depth + 1);
+        }
+    }
+}
+
+void BenchmarkModel::clearBenchmarks() {
+    beginResetModel();
+    benchmarks.clear();
+    endResetModel();
+}
+
+int BenchmarkModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : benchmarks.count();
+}
+
+int BenchmarkModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant BenchmarkModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || index.row() >= benchmarks.count()) return QVariant();
+
+    if (index.column() == NameColumn) {
+        if (role == Qt::DisplayRole || role == SortRole) {
+            return benchmarks.at(index.row()).name;
+        }
+
+        return QVariant();
+    }
+
+    const Benchmark& benchmark = load(index.row());
+
+    switch (index.column()) {
+        case MeanColumn:
+        case MedianColumn: {
+            const Estimate& estimate = index.column() == MeanColumn ? benchmark.mean : benchmark.median;
+            if (!estimate.valid) return QVariant();
+
+            if (role == Qt::DisplayRole) {
+                return formatTime(estimate.point);
+            } else if (role == Qt::ToolTipRole) {
+                return tr("95% confidence interval: %1 .. %2").arg(formatTime(estimate.lower), formatTime(estimate.upper));
+            } else if (role == SortRole) {
+                return estimate.point;
+            }
+
+            break;
+        }
+
+        case ChangeColumn:
+            if (!benchmark.change.valid) return QVariant();
+
+            if (role == Qt::DisplayRole) {
+                return formatPercent(benchmark.change.point);
+            } else if (role == Qt::ToolTipRole) {
+                return tr("95% confidence interval: %1 .. %2").arg(formatPercent(benchmark.change.lower), formatPercent(benchmark.change.upper));
+            } else if (role == SortRole) {
+                return benchmark.change.point;
+            }
+
+            break;
+
+        case VerdictColumn: {
+            Verdict verdict = getVerdict(benchmark.change);
+
+            if (role == Qt::DisplayRole) {
+                switch (verdict) {
+                    case Verdict::NoChange: return tr("No change");
+                    case Verdict::Improved: return tr("Improved");
+                    case Verdict::Regressed: return tr("Regressed");
+                    default: return QVariant();
+                }
+            } else if (role == Qt::ForegroundRole) {
+                if (verdict == Verdict::Improved) return QColor("#00bc00");
+                if (verdict == Verdict::Regressed) return QColor("#cd3131");
+            } else if (role == SortRole) {
+                return static_cast<int>(verdict);
+            }
+
+            break;
+        }
+
+        default:
+            break;
+    }
+
+    return QVariant();
+}
+
+QVariant BenchmarkModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+
+    switch (section) {
+        case NameColumn: return tr("Benchmark");
+        case MeanColumn: return tr("Mean");
+        case MedianColumn: return tr("Median");
+        case ChangeColumn: return tr("Change");
+        case VerdictColumn: return tr("Verdict");
+        default: return QVariant();
+    }
+}
+
+const BenchmarkModel::Benchmark& BenchmarkModel::load(int row) const {
+    Benchmark& benchmark = benchmarks[row];
+    if (benchmark.loaded) return benchmark;
+
+    benchmark.loaded = true;
+    readEstimates(benchmark.path + "/new/estimates.json", benchmark.mean, benchmark.median);
+
+    // Relative change against the baseline, present once a benchmark has run twice.
+    Estimate medianChange;
+    readEstimates(benchmark.path + "/change/estimates.json", benchmark.change, medianChange);
+
+    return benchmark;
+}
+
+void BenchmarkModel::readEstimates(const QString& filePath, Estimate& mean, Estimate& median) {
+    QFile file(filePath);
+    if (!file.exists()) return;
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open benchmark estimates for reading" << filePath;
+        return;
+    }
+
+    QJsonObject obj = QJsonDocument::fromJson(file.readAll()).object();
+
+    auto read = [] (const QJsonObject& obj, Estimate& estimate) {
+        if (!obj.contains("point_estimate")) return;
+
+        QJsonObject interval = obj["confidence_interval"].toObject();
+        estimate.valid = true;
+        estimate.point = obj["point_estimate"].toDouble();
+        estimate.lower = interval["lower_bound"].toDouble();
+        estimate.upper = interval["upper_bound"].toDouble();
+    };
+
+    read(obj["mean"].toObject(), mean);
+    read(obj["median"].toObject(), median);
+}
+
+BenchmarkModel::Verdict BenchmarkModel::getVerdict(const Estimate& change) {
+    if (!change.valid) return Verdict::Unknown;
+    if (change.lower > NOISE_THRESHOLD) return Verdict::Regressed;
+    if (change.upper < -NOISE_THRESHOLD) return Verdict::Improved;
+    return Verdict::NoChange;
+}
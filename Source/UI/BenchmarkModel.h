@@ -0,0 +1,63 @@
+#pragma once
+#include <QAbstractTableModel>
+#include <QVector>
+
+// Criterion results found under target/criterion. Only directory names are read
+// up front, estimates of a benchmark are parsed the first time they are shown.
+class BenchmarkModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    enum Columns {
+        NameColumn,
+        MeanColumn,
+        MedianColumn,
+        ChangeColumn,
+        VerdictColumn,
+        ColumnCount
+    };
+
+    // Raw values used for sorting.
+    static const int SortRole = Qt::UserRole;
+
+    explicit BenchmarkModel(QObject* parent = nullptr);
+
+    void setCriterionPath(const QString& path);
+    void clearBenchmarks();
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    enum class Verdict {
+        Unknown,
+        NoChange,
+        Improved,
+        Regressed
+    };
+
+    struct Estimate {
+        bool valid = false;
+        double point = 0;
+        double lower = 0;
+        double upper = 0;
+    };
+
+    struct Benchmark {
+        QString name;
+        QString path;
+        bool loaded = false;
+        Estimate mean;
+        Estimate median;
+        Estimate change;
+    };
+
+    void findBenchmarks(const QString& path, const QString& name, int depth);
+    const Benchmark& load(int row) const;
+    static void readEstimates(const QString& filePath, Estimate& mean, Estimate& median);
+    static Verdict getVerdict(const Estimate& change);
+
+    mutable QVector<Benchmark> benchmarks;
+};
@@ -0,0 +1,29 @@
+#include "BenchmarkView.h"
+#include "BenchmarkModel.h"
+#include <QtWidgets>
+
+BenchmarkView::BenchmarkView(QWidget* parent) : QTreeView(parent) {
+    benchmarkModel = new BenchmarkModel(this);
+
+    // Sorting by a value column reads all estimates, until then only visible rows are parsed.
+    proxyModel = new QSortFilterProxyModel(this);
+    proxyModel->setSourceModel(benchmarkModel);
+    proxyModel->setSortRole(BenchmarkModel::SortRole);
+    setModel(proxyModel);
+
+    setFrameShape(QFrame::NoFrame);
+    setRootIsDecorated(false);
+    setUniformRowHeights(true);
+    setSortingEnabled(true);
+    sortByColumn(BenchmarkModel::NameColumn, Qt::AscendingOrder);
+    header()->setSectionResizeMode(BenchmarkModel::NameColumn, QHeaderView::Stretch);
+    header()->setStretchLastSection(false);
+}
+
+void BenchmarkView::setCriterionPath(const QString& path) {
+    benchmarkModel->setCriterionPath(path);
+}
+
+void BenchmarkView::clearBenchmarks() {
+    benchmarkModel->clearBenchmarks();
+}
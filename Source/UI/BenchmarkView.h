@@ -0,0 +1,19 @@
+#pragma once
+#include <QTreeView>
+
+class BenchmarkModel;
+class QSortFilterProxyModel;
+
+class BenchmarkView : public QTreeView {
+    Q_OBJECT
+
+public:
+    explicit BenchmarkView(QWidget* parent = nullptr);
+
+    void setCriterionPath(const QString& path);
+    void clearBenchmarks();
+
+private:
+    BenchmarkModel* benchmarkModel;
+    QSortFilterProxyModel* proxyModel;
+};
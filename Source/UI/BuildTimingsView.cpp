@@ -0,0 +1,113 @@
+#include "BuildTimingsView.h"
+#include <QtWidgets>
+
+enum Columns {
+    UnitColumn,
+    TotalColumn,
+    FrontendColumn,
+    CodegenColumn,
+    ChangeColumn,
+    StartColumn
+};
+
+static QString formatSeconds(double seconds) {
+    return QString::number(seconds, 'f', 2);
+}
+
+BuildTimingsView::BuildTimingsView(QWidget* parent) : QWidget(parent) {
+    summaryLabel = new QLabel;
+    summaryLabel->setWordWrap(true);
+    summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    treeWidget = new QTreeWidget;
+    treeWidget->setFrameShape(QFrame::NoFrame);
+    treeWidget->setRootIsDecorated(false);
+    treeWidget->setUniformRowHeights(true);
+    treeWidget->setHeaderLabels(QStringList() << tr("Unit") << tr("Total, s") << tr("Frontend, s")
+                                << tr("Codegen, s") << tr("Change, s") << tr("Start, s"));
+    treeWidget->header()->setSectionResizeMode(UnitColumn, QHeaderView::Stretch);
+    treeWidget->header()->setStretchLastSection(false);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 0, 0);
+    layout->addWidget(summaryLabel);
+    layout->addWidget(treeWidget);
+}
+
+void BuildTimingsView::setTimings(const BuildTimings& timings, const BuildTimings::HistoryEntry* previous) {
+    treeWidget->clear();
+
+    const QVector<BuildTimings::Unit>& units = timings.getUnits();
+
+    // Slowest units first, they are the ones worth looking at.
+    QVector<int> order;
+    for (int i = 0; i < units.count(); i++) {
+        order.append(i);
+    }
+
+    std::sort(order.begin(), order.end(), [&] (int a, int b) {
+        return units.at(a).duration > units.at(b).duration;
+    });
+
+    QFont criticalFont = treeWidget->font();
+    criticalFont.setBold(true);
+
+    QList<QTreeWidgetItem*> items;
+
+    for (int i : order) {
+        const BuildTimings::Unit& unit = units.at(i);
+
+        QTreeWidgetItem* item = new QTreeWidgetItem;
+        item->setText(UnitColumn, unit.name);
+        item->setText(TotalColumn, formatSeconds(unit.duration));
+        item->setText(StartColumn, formatSeconds(unit.start));
+
+        if (unit.frontend >= 0) {
+            item->setText(FrontendColumn, formatSeconds(unit.frontend));
+            item->setText(CodegenColumn, formatSeconds(unit.duration - unit.frontend));
+        }
+
+        if (previous && previous->durations.contains(unit.name)) {
+            double change = unit.duration - previous->durations.value(unit.name);
+            item->setText(ChangeColumn, (change > 0 ? "+" : "") + formatSeconds(change));
+            if (change >= 0.01) {
+                item->setForeground(ChangeColumn, QColor("#cd3131"));
+            } else if (change <= -0.01) {
+                item->setForeground(ChangeColumn, QColor("#00bc00"));
+            }
+        }
+
+        if (unit.critical) {
+            for (int column = 0; column < treeWidget->columnCount(); column++) {
+                item->setFont(column, criticalFont);
+            }
+            item->setToolTip(UnitColumn, tr("On the critical path"));
+        }
+
+        items.append(item);
+    }
+
+    treeWidget->addTopLevelItems(items);
+
+    QStringList criticalNames;
+    for (int i : timings.getCriticalPath()) {
+        criticalNames.append(units.at(i).name.section(' ', 0, 0));
+    }
+
+    QString summary = tr("Total: %1 s, %2 units").arg(formatSeconds(timings.getTotal())).arg(units.count());
+    if (previous) {
+        double change = timings.getTotal() - previous->total;
+        summary += tr(" (%1%2 s since %3)")
+                .arg(change > 0 ? "+" : "")
+                .arg(formatSeconds(change))
+                .arg(QDateTime::fromString(previous->date, Qt::ISODate).toString(Qt::SystemLocaleShortDate));
+    }
+
+    summary += "\n" + tr("Critical path (bold): %1").arg(criticalNames.join(" → "));
+    summaryLabel->setText(summary);
+}
+
+void BuildTimingsView::clearTimings() {
+    treeWidget->clear();
+    summaryLabel->clear();
+}
@@ -0,0 +1,21 @@
+#pragma once
+#include "Process/BuildTimings.h"
+#include <QWidget>
+
+class QLabel;
+class QTreeWidget;
+
+// Per-unit compile times of the last timed build compared to the previous one.
+class BuildTimingsView : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit BuildTimingsView(QWidget* parent = nullptr);
+
+    void setTimings(const BuildTimings& timings, const BuildTimings::HistoryEntry* previous = nullptr);
+    void clearTimings();
+
+private:
+    QLabel* summaryLabel;
+    QTreeWidget* treeWidget;
+};
@@ -0,0 +1,252 @@
+#include "CodegenView.h"
+#include "Core/Constants.h"
+#include "Core/Global.h"
+#include <QtWidgets>
+
+// Finds the cached output of a fingerprint and indexes it, both read the disk.
+class CodegenLookup : public QRunnable {
+public:
+    CodegenLookup(CodegenView* view, int request, CodegenIndex::Kind kind, const QStringList& packagePaths,
+            const QString& target, const QString& cachePath, QSharedPointer<CodegenIndex> index) :
+            view(view),
+            request(request),
+            kind(kind),
+            packagePaths(packagePaths),
+            target(target),
+            cachePath(cachePath),
+            index(index) {
+    }
+
+    void run() override {
+        // Emitted code depends on the crate as well as on the sources.
+        QString fingerprint = CodegenView::getEmitType(kind) + ":" + target + ":" + Global::getSourcesStamp(packagePaths);
+        QString outputPath = CodegenView::getCachedOutput(cachePath, kind, fingerprint);
+
+        if (!outputPath.isEmpty() && !index->isBuiltFrom(outputPath)) {
+            index->build(outputPath, kind);
+        }
+
+        emit view->lookupFinished(request, fingerprint, outputPath);
+    }
+
+private:
+    CodegenView* view;
+    int request;
+    CodegenIndex::Kind kind;
+    QStringList packagePaths;
+    QString target;
+    QString cachePath;
+    QSharedPointer<CodegenIndex> index;
+};
+
+CodegenView::CodegenView(QWidget* parent) : QWidget(parent) {
+    pool = new QThreadPool(this);
+    pool->setMaxThreadCount(1);
+    connect(this, &CodegenView::lookupFinished, this, &CodegenView::onLookupFinished, Qt::QueuedConnection);
+
+    titleLabel = new QLabel;
+    titleLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    plainTextEdit = new QPlainTextEdit;
+    plainTextEdit->setFrameShape(QFrame::NoFrame);
+    plainTextEdit->setReadOnly(true);
+    plainTextEdit->setLineWrapMode(QPlainTextEdit::NoWrap);
+    plainTextEdit->document()->setUndoRedoEnabled(false);
+    plainTextEdit->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    plainTextEdit->setTabStopWidth(4 * plainTextEdit->fontMetrics().width(' '));
+
+    // Clicking an instruction shows the source line it was generated from.
+    connect(plainTextEdit, &QPlainTextEdit::cursorPositionChanged, [=] {
+        int row = plainTextEdit->textCursor().blockNumber();
+        if (row >= listing.locations.count()) return;
+
+        const CodegenIndex::Location& location = listing.locations.at(row);
+        if (location.file != -1 && plainTextEdit->hasFocus()) {
+            sourceLine = location.line;
+            highlightSourceLine();
+            emit locationActivated(getIndex(kind).getSourcePath(location.file), location.line, 1);
+            plainTextEdit->setFocus();
+        }
+    });
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 0, 0);
+    layout->addWidget(titleLabel);
+    layout->addWidget(plainTextEdit);
+}
+
+CodegenView::~CodegenView() {
+    // Lookups emit on this object.
+    pool->waitForDone();
+}
+
+void CodegenView::setProjectPath(const QString& path) {
+    projectPath = path;
+    packagePaths = QStringList(path);
+}
+
+void CodegenView::setPackagePaths(const QStringList& paths) {
+    packagePaths = paths;
+}
+
+void CodegenView::showFunction(CodegenIndex::Kind kind, const QString& sourcePath, int line, const QString& target) {
+    this->kind = kind;
+    this->sourcePath = sourcePath;
+    sourceLine = line;
+    this->target = target;
+    pendingFingerprint.clear();
+
+    // A copy shares the data of the current index, which is kept if it is still valid.
+    lookupRequest++;
+    lookupIndex.reset(new CodegenIndex(getIndex(kind)));
+    titleLabel->setText(tr("Loading %1...").arg(getEmitType(kind)));
+    pool->start(new CodegenLookup(this, lookupRequest, kind, packagePaths, target, getCachePath(), lookupIndex));
+}
+
+void CodegenView::onLookupFinished(int request, const QString& fingerprint, const QString& outputPath) {
+    if (request != lookupRequest) return;
+
+    QSharedPointer<CodegenIndex> index = lookupIndex;
+    lookupIndex.reset();
+
+    if (outputPath.isEmpty()) {
+        pendingFingerprint = fingerprint;
+        titleLabel->setText(tr("Emitting %1...").arg(getEmitType(kind)));
+        emit emitRequested(getEmitType(kind));
+        return;
+    }
+
+    getIndex(kind) = *index;
+    showListing();
+}
+
+void CodegenView::setOutput(const QString& outputPath) {
+    if (pendingFingerprint.isEmpty()) return;
+
+    if (outputPath.isEmpty()) {
+        pendingFingerprint.clear();
+        titleLabel->setText(tr("Failed to emit %1, see the Cargo output").arg(getEmitType(kind)));
+        return;
+    }
+
+    saveCachedOutput(kind, pendingFingerprint, outputPath);
+    pendingFingerprint.clear();
+    showFunction(kind, sourcePath, sourceLine, target);
+}
+
+void CodegenView::clearCodegen() {
+    // Results of running lookups are dropped.
+    lookupRequest++;
+    lookupIndex.reset();
+    assemblyIndex.clear();
+    llvmIrIndex.clear();
+    pendingFingerprint.clear();
+    listing = CodegenIndex::Listing();
+    titleLabel->clear();
+    plainTextEdit->clear();
+}
+
+QString CodegenView::getEmitType(CodegenIndex::Kind kind) {
+    return kind == CodegenIndex::Kind::Assembly ? "asm" : "llvm-ir";
+}
+
+QString CodegenView::getCachedOutput(const QString& cachePath, CodegenIndex::Kind kind, const QString& fingerprint) {
+    QFile file(cachePath);
+    if (!file.open(QIODevice::ReadOnly)) return QString();
+
+    QJsonObject entry = QJsonDocument::fromJson(file.readAll()).object()[getEmitType(kind)].toObject();
+    QString outputPath = entry["path"].toString();
+
+    bool valid = entry["fingerprint"].toString() == fingerprint
+            && QFileInfo(outputPath).lastModified().toMSecsSinceEpoch() == entry["modified"].toVariant().toLongLong();
+
+    return valid ? outputPath : QString();
+}
+
+void CodegenView::saveCachedOutput(CodegenIndex::Kind kind, const QString& fingerprint, const QString& outputPath) {
+    QString cachePath = getCachePath();
+    QJsonObject cache;
+    QFile cacheFile(cachePath);
+    if (cacheFile.open(QIODevice::ReadOnly)) {
+        cache = QJsonDocument::fromJson(cacheFile.readAll()).object();
+        cacheFile.close();
+    }
+
+    QJsonObject entry;
+    entry["fingerprint"] = fingerprint;
+    entry["path"] = outputPath;
+    entry["modified"] = QString::number(QFileInfo(outputPath).lastModified().toMSecsSinceEpoch());
+    cache[getEmitType(kind)] = entry;
+
+    QDir().mkpath(QFileInfo(cachePath).absolutePath());
+
+    // Lookups read the cache from the pool, they see either the old or the new file.
+    QSaveFile file(cachePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open codegen cache file for writing" << cachePath;
+        return;
+    }
+
+    file.write(QJsonDocument(cache).toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qWarning() << "Failed to write codegen cache file" << cachePath << file.errorString();
+    }
+}
+
+QString CodegenView::getCachePath() const {
+    return projectPath + "/" + Constants::PROJECT_DATA_DIRECTORY + "/" + Constants::PROJECT_CODEGEN_FILE;
+}
+
+CodegenIndex& CodegenView::getIndex(CodegenIndex::Kind kind) {
+    return kind == CodegenIndex::Kind::Assembly ? assemblyIndex : llvmIrIndex;
+}
+
+void CodegenView::showListing() {
+    CodegenIndex& index = getIndex(kind);
+    int function = index.findFunction(sourcePath, sourceLine);
+
+    if (function == -1) {
+        listing = CodegenIndex::Listing();
+        plainTextEdit->clear();
+        titleLabel->setText(tr("No code generated for %1:%2 (%3 functions indexed)")
+                .arg(QFileInfo(sourcePath).fileName())
+                .arg(sourceLine)
+                .arg(index.getFunctionCount()));
+        return;
+    }
+
+    listing = index.getListing(function);
+    titleLabel->setText(listing.name);
+    plainTextEdit->setPlainText(listing.lines.join('\n'));
+    highlightSourceLine();
+}
+
+void CodegenView::highlightSourceLine() {
+    QList<QTextEdit::ExtraSelection> selections;
+    QTextBlock firstBlock;
+    QString cleanSourcePath = QDir::cleanPath(sourcePath);
+    CodegenIndex& index = getIndex(kind);
+
+    for (int i = 0; i < listing.locations.count(); i++) {
+        const CodegenIndex::Location& location = listing.locations.at(i);
+        if (location.line != sourceLine || index.getSourcePath(location.file) != cleanSourcePath) continue;
+
+        QTextEdit::ExtraSelection selection;
+        selection.format.setBackground(QColor(Qt::yellow).lighter(160));
+        selection.format.setProperty(QTextFormat::FullWidthSelection, true);
+        selection.cursor = QTextCursor(plainTextEdit->document()->findBlockByNumber(i));
+        selections.append(selection);
+
+        if (!firstBlock.isValid()) {
+            firstBlock = selection.cursor.block();
+        }
+    }
+
+    plainTextEdit->setExtraSelections(selections);
+
+    if (firstBlock.isValid() && !plainTextEdit->hasFocus()) {
+        QTextCursor cursor(firstBlock);
+        plainTextEdit->setTextCursor(cursor);
+        plainTextEdit->centerCursor();
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include "Process/CodegenIndex.h"
+#include <QWidget>
+#include <QSharedPointer>
+
+class QLabel;
+class QPlainTextEdit;
+class QThreadPool;
+
+// Assembly or LLVM IR of the function under the editor cursor. Emitted files
+// are remembered per build fingerprint in the project data directory.
+// The fingerprint and the index are computed on a pool thread.
+class CodegenView : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit CodegenView(QWidget* parent = nullptr);
+    ~CodegenView();
+
+    void setProjectPath(const QString& path);
+    // Directories of the local packages the sources stamp covers, the project by default.
+    void setPackagePaths(const QStringList& paths);
+    // Target identifies the emitted crate, e.g. "bin name".
+    void showFunction(CodegenIndex::Kind kind, const QString& sourcePath, int line, const QString& target);
+    void setOutput(const QString& outputPath);
+    void clearCodegen();
+
+    static QString getEmitType(CodegenIndex::Kind kind);
+
+signals:
+    void emitRequested(const QString& emitType);
+    void locationActivated(const QString& filePath, int line, int column);
+    // Delivers the result of a lookup from the pool to the view's thread.
+    void lookupFinished(int request, const QString& fingerprint, const QString& outputPath);
+
+private slots:
+    void onLookupFinished(int request, const QString& fingerprint, const QString& outputPath);
+
+private:
+    friend class CodegenLookup;
+
+    static QString getCachedOutput(const QString& cachePath, CodegenIndex::Kind kind, const QString& fingerprint);
+    void saveCachedOutput(CodegenIndex::Kind kind, const QString& fingerprint, const QString& outputPath);
+    QString getCachePath() const;
+    CodegenIndex& getIndex(CodegenIndex::Kind kind);
+    void showListing();
+    void highlightSourceLine();
+
+    QString projectPath;
+    QStringList packagePaths;
+    CodegenIndex assemblyIndex;
+    CodegenIndex llvmIrIndex;
+
+    CodegenIndex::Kind kind = CodegenIndex::Kind::Assembly;
+    QString sourcePath;
+    int sourceLine = 0;
+    QString target;
+    QString pendingFingerprint;
+
+    QThreadPool* pool;
+    int lookupRequest = 0;
+    // Built by the latest lookup, taken over when it finishes.
+    QSharedPointer<CodegenIndex> lookupIndex;
+
+    CodegenIndex::Listing listing;
+    QLabel* titleLabel;
+    QPlainTextEdit* plainTextEdit;
+};
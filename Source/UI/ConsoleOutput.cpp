@@ -0,0 +1,282 @@
+#include "ConsoleOutput.h"
+#include "Core/Preferences.h"
+#include <QtWidgets>
+#include <algorithm>
+
+// Output is coalesced and inserted at most once per frame.
+static const int FLUSH_INTERVAL = 16;
+
+ConsoleOutput::ConsoleOutput(QWidget* parent) : QPlainTextEdit(parent) {
+    flushTimer = new QTimer(this);
+    flushTimer->setSingleShot(true);
+    flushTimer->setInterval(FLUSH_INTERVAL);
+    connect(flushTimer, &QTimer::timeout, this, &ConsoleOutput::flush);
+
+    document()->setUndoRedoEnabled(false);
+    viewport()->setMouseTracking(true);
+
+    applySettings();
+    connect(Preferences::getInstance(), &Preferences::outputChanged, this, &ConsoleOutput::applySettings);
+}
+
+void ConsoleOutput::appendMessage(const QString& message) {
+    pending += message;
+
+    if (!flushTimer->isActive()) {
+        flushTimer->start();
+    }
+}
+
+void ConsoleOutput::clearOutput() {
+    flushTimer->stop();
+    pending.clear();
+    escapeParser.reset();
+    clear();
+
+    locations.clear();
+    files.clear();
+    fileIds.clear();
+    resolvedFiles.clear();
+    appendedLines = 0;
+    scannedLines = 0;
+    currentLocation = -1;
+    pressedLocation = -1;
+
+    if (logFile.isOpen()) {
+        logFile.resize(0);
+    }
+}
+
+void ConsoleOutput::setLogFilePath(const QString& path) {
+    logFilePath = path;
+    openLogFile();
+}
+
+void ConsoleOutput::applySettings() {
+    // Oldest lines are dropped from the top when the limit is exceeded.
+    setMaximumBlockCount(Preferences::getInstance()->getOutput().maxLines);
+    openLogFile();
+}
+
+void ConsoleOutput::setPathResolver(const std::function<QString(const QString&)>& resolver) {
+    pathResolver = resolver;
+
+    for (QString& filePath : resolvedFiles) {
+        filePath = QString();
+    }
+}
+
+void ConsoleOutput::nextLocation() {
+    stepLocation(1);
+}
+
+void ConsoleOutput::previousLocation() {
+    stepLocation(-1);
+}
+
+void ConsoleOutput::mouseMoveEvent(QMouseEvent* event) {
+    QPlainTextEdit::mouseMoveEvent(event);
+
+    if (event->buttons() == Qt::NoButton) {
+        viewport()->setCursor(findLocation(event->pos()) != -1 ? Qt::PointingHandCursor : Qt::IBeamCursor);
+    }
+}
+
+void ConsoleOutput::mousePressEvent(QMouseEvent* event) {
+    QPlainTextEdit::mousePressEvent(event);
+    pressedLocation = event->button() == Qt::LeftButton ? findLocation(event->pos()) : -1;
+}
+
+void ConsoleOutput::mouseReleaseEvent(QMouseEvent* event) {
+    QPlainTextEdit::mouseReleaseEvent(event);
+
+    // A click, not the end of a selection.
+    if (event->button() == Qt::LeftButton && pressedLocation != -1
+            && !textCursor().hasSelection() && findLocation(event->pos()) == pressedLocation) {
+        activateLocation(pressedLocation);
+    }
+
+    pressedLocation = -1;
+}
+
+void ConsoleOutput::flush() {
+    if (pending.isEmpty()) return;
+
+    QScrollBar* scrollBar = verticalScrollBar();
+    bool atBottom = scrollBar->value() == scrollBar->maximum();
+
+    escapeParser.parse(pending, runs);
+    pending.clear();
+
+    QTextCursor cursor(document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.beginEditBlock();
+
+    // Lines over the limit are only removed when the edit block ends.
+    int blockCount = document()->blockCount();
+
+    for (const AnsiEscapeParser::Run& run : runs) {
+        cursor.insertText(run.text, run.format);
+
+        if (logFile.isOpen()) {
+            logFile.write(run.text.toUtf8());
+        }
+    }
+
+    appendedLines += document()->blockCount() - blockCount;
+    cursor.endEditBlock();
+    runs.clear();
+
+    indexLocations();
+
+    // Keep following the output only if the user has not scrolled up.
+    if (atBottom) {
+        scrollBar->setValue(scrollBar->maximum());
+    }
+}
+
+void ConsoleOutput::openLogFile() {
+    bool enabled = Preferences::getInstance()->getOutput().logToFile && !logFilePath.isEmpty();
+
+    if (logFile.isOpen() && (!enabled || logFile.fileName() != logFilePath)) {
+        logFile.close();
+    }
+
+    if (!enabled || logFile.isOpen()) return;
+
+    QDir().mkpath(QFileInfo(logFilePath).absolutePath());
+
+    logFile.setFileName(logFilePath);
+    if (!logFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Failed to open output log file for writing" << logFilePath;
+    }
+}
+
+void ConsoleOutput::indexLocations() {
+    // cargo and rustc "--> src/main.rs:42:7", panics "panicked at src/main.rs:2:5:",
+    // backtraces "at ./src/main.rs:2:5". The extension keeps times and addresses out.
+    static const QRegularExpression locationRegExp(
+            "((?:[A-Za-z]:[\\\\/])?[^\\s:'\"`()\\[\\]<>,]+\\.[A-Za-z]\\w*):(\\d+)(?::(\\d+))?");
+
+    int firstLine = getFirstLine();
+
+    // Forget locations on lines dropped from the top.
+    auto first = std::lower_bound(locations.begin(), locations.end(), firstLine, [] (const Location& location, int line) {
+        return location.outputLine < line;
+    });
+    int dropped = static_cast<int>(first - locations.begin());
+    if (dropped) {
+        locations.remove(0, dropped);
+        currentLocation = qMax(-1, currentLocation - dropped);
+    }
+
+    scannedLines = qMax(scannedLines, firstLine);
+    if (scannedLines >= appendedLines) return;
+
+    QTextCharFormat linkFormat;
+    linkFormat.setFontUnderline(true);
+
+    QTextCursor cursor(document());
+    cursor.beginEditBlock();
+
+    // The last line is still being written.
+    QTextBlock block = document()->findBlockByNumber(scannedLines - firstLine);
+    for (; block.isValid() && scannedLines < appendedLines; block = block.next(), scannedLines++) {
+        QRegularExpressionMatchIterator it = locationRegExp.globalMatch(block.text());
+        while (it.hasNext()) {
+            QRegularExpressionMatch match = it.next();
+            QString filePath = match.captured(1);
+
+            auto fileIt = fileIds.find(filePath);
+            if (fileIt == fileIds.end()) {
+                files.append(filePath);
+                resolvedFiles.append(QString());
+                fileIt = fileIds.insert(filePath, files.count() - 1);
+            }
+
+            Location location;
+            location.outputLine = scannedLines;
+            location.start = match.capturedStart();
+            location.length = match.capturedLength();
+            location.file = fileIt.value();
+            location.line = match.captured(2).toInt();
+            location.column = qMax(1, match.captured(3).toInt());
+            locations.append(location);
+
+            cursor.setPosition(block.position() + location.start);
+            cursor.setPosition(block.position() + location.start + location.length, QTextCursor::KeepAnchor);
+            cursor.mergeCharFormat(linkFormat);
+        }
+    }
+
+    cursor.endEditBlock();
+}
+
+int ConsoleOutput::getFirstLine() const {
+    // The last block is the one after the last line break.
+    return appendedLines - (document()->blockCount() - 1);
+}
+
+int ConsoleOutput::findLocation(const QPoint& pos) const {
+    QTextCursor cursor = cursorForPosition(pos);
+    int outputLine = cursor.blockNumber() + getFirstLine();
+    int column = cursor.positionInBlock();
+
+    auto it = std::lower_bound(locations.begin(), locations.end(), outputLine, [] (const Location& location, int line) {
+        return location.outputLine < line;
+    });
+
+    for (; it != locations.end() && it->outputLine == outputLine; ++it) {
+        if (column >= it->start && column < it->start + it->length) {
+            return static_cast<int>(it - locations.begin());
+        }
+    }
+
+    return -1;
+}
+
+bool ConsoleOutput::activateLocation(int index) {
+    const Location& location = locations.at(index);
+
+    QString filePath = resolveFile(location.file);
+    if (filePath.isEmpty()) return false;
+
+    currentLocation = index;
+
+    QTextBlock block = document()->findBlockByNumber(location.outputLine - getFirstLine());
+    QTextCursor cursor(block);
+    cursor.setPosition(block.position() + location.start);
+    cursor.setPosition(block.position() + location.start + location.length, QTextCursor::KeepAnchor);
+    setTextCursor(cursor);
+    ensureCursorVisible();
+
+    emit locationActivated(filePath, location.line, location.column);
+    return true;
+}
+
+void ConsoleOutput::stepLocation(int step) {
+    flush();
+
+    // Locations that don't exist on disk, e.g. in the standard library, are skipped.
+    int count = locations.count();
+    int index = currentLocation;
+
+    for (int i = 0; i < count; i++) {
+        if (index == -1) {
+            index = step > 0 ? 0 : count - 1;
+        } else {
+            index = (index + step + count) % count;
+        }
+
+        if (activateLocation(index)) return;
+    }
+}
+
+QString ConsoleOutput::resolveFile(int file) {
+    if (resolvedFiles.at(file).isNull()) {
+        QString filePath = pathResolver ? pathResolver(files.at(file)) : files.at(file);
+        resolvedFiles[file] = QFileInfo::exists(filePath) ? filePath : QString("");
+    }
+
+    return resolvedFiles.at(file);
+}
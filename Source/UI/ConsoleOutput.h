@@ -0,0 +1,77 @@
+#pragma once
+#include "AnsiEscapeParser.h"
+#include <QPlainTextEdit>
+#include <QFile>
+#include <functional>
+
+class QTimer;
+
+class ConsoleOutput : public QPlainTextEdit {
+    Q_OBJECT
+
+public:
+    explicit ConsoleOutput(QWidget* parent = nullptr);
+
+    void appendMessage(const QString& message);
+    void clearOutput();
+
+    void setLogFilePath(const QString& path);
+    void applySettings();
+
+    // Maps a path found in the output to a file, e.g. relative to the project.
+    void setPathResolver(const std::function<QString(const QString&)>& resolver);
+
+public slots:
+    void nextLocation();
+    void previousLocation();
+
+signals:
+    void locationActivated(const QString& filePath, int line, int column);
+
+protected:
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+
+private slots:
+    void flush();
+
+private:
+    // Source location like src/main.rs:42:7 on a line of the output.
+    struct Location {
+        int outputLine;
+        int start;
+        int length;
+        int file;
+        int line;
+        int column;
+    };
+
+    void openLogFile();
+    void indexLocations();
+    int getFirstLine() const;
+    int findLocation(const QPoint& pos) const;
+    bool activateLocation(int index);
+    void stepLocation(int step);
+    QString resolveFile(int file);
+
+    QTimer* flushTimer;
+    QString pending;
+    AnsiEscapeParser escapeParser;
+    QVector<AnsiEscapeParser::Run> runs;
+    QString logFilePath;
+    QFile logFile;
+
+    // Lines are numbered from the last clear, so entries stay valid while
+    // old lines are dropped from the top. Only complete lines are scanned.
+    QVector<Location> locations;
+    QStringList files;
+    QHash<QString, int> fileIds;
+    // Null until resolved, empty if the file doesn't exist.
+    QStringList resolvedFiles;
+    std::function<QString(const QString&)> pathResolver;
+    int appendedLines = 0;
+    int scannedLines = 0;
+    int currentLocation = -1;
+    int pressedLocation = -1;
+};
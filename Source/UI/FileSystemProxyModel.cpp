@@ -1,32 +1,139 @@
 #include "FileSystemProxyModel.h"
 #include <QFileSystemModel>
+#include <QDir>
 
 FileSystemProxyModel::FileSystemProxyModel(QObject* parent) :
     QSortFilterProxyModel(parent) {
 }
 
+void FileSystemProxyModel::setSourceModel(QAbstractItemModel* sourceModel) {
+    if (this->sourceModel()) {
+        disconnect(this->sourceModel(), nullptr, this, nullptr);
+    }
+
+    sortKeys.clear();
+
+    // Connected before the base class does, so stale keys are gone when it re-sorts.
+    if (sourceModel) {
+        connect(sourceModel, &QAbstractItemModel::dataChanged, this, [=] (const QModelIndex& topLeft, const QModelIndex& bottomRight) {
+            if (topLeft.column() == 0) {
+                removeSortKeys(topLeft.parent(), topLeft.row(), bottomRight.row());
+            }
+        });
+
+        // Nodes of removed entries, including their children, may be reused for new ones.
+        connect(sourceModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, [=] {
+            sortKeys.clear();
+        });
+
+        connect(sourceModel, &QAbstractItemModel::modelAboutToBeReset, this, [=] {
+            sortKeys.clear();
+        });
+
+        connect(sourceModel, &QAbstractItemModel::layoutAboutToBeChanged, this, [=] {
+            sortKeys.clear();
+        });
+    }
+
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
+
+void FileSystemProxyModel::setExclusion(const QString& rootPath, const IgnoreMatcher& matcher) {
+    this->rootPath = QDir::cleanPath(QDir::fromNativeSeparators(rootPath));
+    ignoreMatcher = matcher;
+    invalidateFilter();
+}
+
+bool FileSystemProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const {
+    QFileSystemModel* fsm = qobject_cast<QFileSystemModel*>(sourceModel());
+    if (!fsm || ignoreMatcher.isEmpty() || rootPath.isEmpty()) return true;
+
+    QModelIndex index = fsm->index(sourceRow, 0, sourceParent);
+    QString filePath = fsm->filePath(index);
+
+    // The root and the directories above it are always shown.
+    if (filePath.size() <= rootPath.size() + 1 || !filePath.startsWith(rootPath) || filePath.at(rootPath.size()) != '/') {
+        return true;
+    }
+
+    return !ignoreMatcher.isExcluded(filePath.mid(rootPath.size() + 1), fsm->isDir(index));
+}
+
 bool FileSystemProxyModel::lessThan(const QModelIndex& left, const QModelIndex& right) const {
     // If sorting by file names column
     if (sortColumn() == 0) {
-        QFileSystemModel *fsm = qobject_cast<QFileSystemModel*>(sourceModel());
-        bool asc = sortOrder() == Qt::AscendingOrder ? true : false;
+        // Copies, a lookup may insert and rehash.
+        SortKey leftKey = getSortKey(left);
+        SortKey rightKey = getSortKey(right);
+
+        // ".." and directories stay on top in both orders.
+        bool asc = sortOrder() == Qt::AscendingOrder;
+        if (leftKey.group != rightKey.group) {
+            return (leftKey.group < rightKey.group) == asc;
+        }
+
+        return leftKey.name < rightKey.name;
+    }
+
+    return QSortFilterProxyModel::lessThan(left, right);
+}
+
+FileSystemProxyModel::SortKey FileSystemProxyModel::getSortKey(const QModelIndex& index) const {
+    auto it = sortKeys.find(index.internalPointer());
+    if (it != sortKeys.end()) return it.value();
 
-        QFileInfo leftFileInfo  = fsm->fileInfo(left);
-        QFileInfo rightFileInfo = fsm->fileInfo(right);
+    QString name = index.data().toString();
+    QFileSystemModel* fsm = qobject_cast<QFileSystemModel*>(sourceModel());
 
-        // If DotAndDot move in the beginning
-        if (sourceModel()->data(left).toString() == "..")  return asc;
-        if (sourceModel()->data(right).toString() == "..") return !asc;
+    SortKey key;
+    if (name == "..") {
+        key.group = 0;
+    } else {
+        key.group = fsm && fsm->isDir(index) ? 1 : 2;
+    }
 
-        // Move dirs upper
-        if (!leftFileInfo.isDir() && rightFileInfo.isDir()) {
-            return !asc;
+    // The original name breaks ties between names that only differ in case.
+    key.name = naturalKey(name) + QChar(0) + name;
+
+    sortKeys.insert(index.internalPointer(), key);
+    return key;
+}
+
+void FileSystemProxyModel::removeSortKeys(const QModelIndex& parent, int first, int last) {
+    for (int row = first; row <= last; row++) {
+        sortKeys.remove(sourceModel()->index(row, 0, parent).internalPointer());
+    }
+}
+
+QString FileSystemProxyModel::naturalKey(const QString& name) {
+    // Case-folded, with each run of digits prefixed by its length without
+    // leading zeros, so plain string comparison orders numbers by value.
+    // A '0' before the length makes the run sort against other characters
+    // like a digit does, e.g. "file.rs" before "file1.rs".
+    QString key;
+    key.reserve(name.size() + 8);
+
+    int i = 0;
+    while (i < name.size()) {
+        if (!name.at(i).isDigit()) {
+            key += name.at(i).toCaseFolded();
+            i++;
+            continue;
         }
 
-        if (leftFileInfo.isDir() && !rightFileInfo.isDir()) {
-            return asc;
+        while (i < name.size() - 1 && name.at(i) == '0' && name.at(i + 1).isDigit()) {
+            i++;
         }
+
+        int begin = i;
+        while (i < name.size() && name.at(i).isDigit()) {
+            i++;
+        }
+
+        key += '0';
+        key += QChar(1 + qMin(i - begin, 0xfff0));
+        key += name.midRef(begin, i - begin);
     }
 
-    return QSortFilterProxyModel::lessThan(left, right);
+    return key;
 }
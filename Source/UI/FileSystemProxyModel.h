@@ -1,11 +1,37 @@
 #pragma once
+#include "Core/IgnoreMatcher.h"
 #include <QSortFilterProxyModel>
+#include <QHash>
 
+// Sorts directories first, then by name in natural order (file2 before file10).
+// Sort keys are computed once per entry and dropped when the entry changes.
+// Excluded entries are hidden, so their contents are never listed or watched.
 class FileSystemProxyModel : public QSortFilterProxyModel {
 
 public:
     FileSystemProxyModel(QObject* parent = nullptr);
 
+    void setSourceModel(QAbstractItemModel* sourceModel) override;
+    void setExclusion(const QString& rootPath, const IgnoreMatcher& matcher);
+
 protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
     bool lessThan(const QModelIndex& left, const QModelIndex& right) const override;
+
+private:
+    struct SortKey {
+        // 0 for "..", 1 for directories, 2 for files.
+        int group;
+        QString name;
+    };
+
+    SortKey getSortKey(const QModelIndex& index) const;
+    void removeSortKeys(const QModelIndex& parent, int first, int last);
+    static QString naturalKey(const QString& name);
+
+    // Keyed by the source model's internal pointer, which is stable per entry.
+    mutable QHash<const void*, SortKey> sortKeys;
+
+    QString rootPath;
+    IgnoreMatcher ignoreMatcher;
 };
@@ -0,0 +1,234 @@
+#include "FlameGraph.h"
+#include <QtWidgets>
+
+static const int ROW_HEIGHT = 18;
+// Narrower frames are not drawn, which bounds the work per paint regardless of the sample count.
+static const double MIN_FRAME_WIDTH = 0.5;
+static const int MIN_LABEL_WIDTH = 30;
+
+FlameGraph::FlameGraph(QWidget* parent) : QWidget(parent) {
+    setMouseTracking(true);
+}
+
+void FlameGraph::setCallTree(const QSharedPointer<CallTree>& callTree) {
+    this->callTree = callTree;
+    matches.clear();
+    searching = false;
+    resetZoom();
+}
+
+void FlameGraph::clearCallTree() {
+    setCallTree(QSharedPointer<CallTree>());
+}
+
+void FlameGraph::setSearchText(const QString& text) {
+    searching = !text.isEmpty() && callTree;
+    matches.clear();
+
+    if (!searching) {
+        emit searchMatched(0, 0);
+        update();
+        return;
+    }
+
+    int count = callTree->getNodeCount();
+    matches.resize(count);
+    QVector<bool> covered(count, false);
+    qint64 samples = 0;
+
+    // Parents always precede their children, so one pass counts every
+    // sample once even when matching frames are nested.
+    for (int i = 1; i < count; i++) {
+        const CallTree::Node& node = callTree->getNode(i);
+        bool parentCovered = covered.at(node.parent);
+        matches[i] = callTree->getName(i).contains(text, Qt::CaseInsensitive);
+        covered[i] = parentCovered || matches.at(i);
+
+        if (matches.at(i) && !parentCovered) {
+            samples += node.total;
+        }
+    }
+
+    emit searchMatched(samples, callTree->getSampleCount());
+    update();
+}
+
+void FlameGraph::zoomTo(int node) {
+    zoomNode = node;
+
+    QStringList path;
+    if (callTree) {
+        for (int i = node; i != -1; i = callTree->getNode(i).parent) {
+            path.prepend(callTree->getName(i));
+        }
+    }
+
+    emit zoomChanged(path.join(" ▸ "));
+    updateHeight();
+    update();
+}
+
+void FlameGraph::zoomOut() {
+    if (callTree && zoomNode != CallTree::ROOT) {
+        zoomTo(callTree->getNode(zoomNode).parent);
+    }
+}
+
+void FlameGraph::resetZoom() {
+    zoomTo(CallTree::ROOT);
+}
+
+bool FlameGraph::event(QEvent* event) {
+    if (event->type() == QEvent::ToolTip) {
+        QHelpEvent* helpEvent = static_cast<QHelpEvent*>(event);
+        int node = nodeAt(helpEvent->pos());
+        if (node == -1) {
+            QToolTip::hideText();
+            event->ignore();
+            return true;
+        }
+
+        const CallTree::Node& data = callTree->getNode(node);
+        double percent = 100.0 * data.total / qMax<qint64>(1, callTree->getSampleCount());
+        QString text = tr("%1\n%2 samples (%3%), self %4")
+                .arg(callTree->getName(node))
+                .arg(data.total)
+                .arg(percent, 0, 'f', 2)
+                .arg(data.self);
+
+        QString source = callTree->getSource(node);
+        if (!source.isEmpty()) {
+            text += "\n" + source;
+        }
+
+        QToolTip::showText(helpEvent->globalPos(), text, this);
+        return true;
+    }
+
+    return QWidget::event(event);
+}
+
+void FlameGraph::paintEvent(QPaintEvent* event) {
+    QPainter painter(this);
+    painter.fillRect(event->rect(), palette().color(QPalette::Base));
+
+    if (!callTree || !callTree->getSampleCount()) return;
+
+    struct Frame {
+        int node;
+        double x;
+        double width;
+        int depth;
+    };
+
+    QRect clip = event->rect();
+    QFontMetrics metrics = painter.fontMetrics();
+
+    QVector<Frame> frames;
+    frames.append({ zoomNode, 0, static_cast<double>(width()), 0 });
+
+    while (!frames.isEmpty()) {
+        Frame frame = frames.takeLast();
+        int y = frame.depth * ROW_HEIGHT;
+        if (y > clip.bottom()) continue;
+
+        if (y + ROW_HEIGHT > clip.top() && frame.x <= clip.right() && frame.x + frame.width >= clip.left()) {
+            QRectF rect(frame.x, y, frame.width - 1, ROW_HEIGHT - 1);
+            painter.fillRect(rect, getColor(frame.node));
+
+            if (frame.width > MIN_LABEL_WIDTH) {
+                QString label = metrics.elidedText(callTree->getName(frame.node), Qt::ElideRight, static_cast<int>(frame.width) - 6);
+                painter.setPen(Qt::black);
+                painter.drawText(rect.adjusted(3, 0, -3, 0), Qt::AlignLeft | Qt::AlignVCenter, label);
+            }
+        }
+
+        const CallTree::Node& node = callTree->getNode(frame.node);
+        double x = frame.x;
+        for (int child = node.firstChild; child != -1; child = callTree->getNode(child).nextSibling) {
+            double childWidth = frame.width * callTree->getNode(child).total / node.total;
+            if (childWidth >= MIN_FRAME_WIDTH) {
+                frames.append({ child, x, childWidth, frame.depth + 1 });
+            }
+            x += childWidth;
+        }
+    }
+}
+
+void FlameGraph::mousePressEvent(QMouseEvent* event) {
+    if (event->button() == Qt::LeftButton) {
+        int node = nodeAt(event->pos());
+        if (node != -1 && node != zoomNode) {
+            zoomTo(node);
+        }
+    } else if (event->button() == Qt::RightButton) {
+        zoomOut();
+    }
+}
+
+void FlameGraph::mouseDoubleClickEvent(QMouseEvent* event) {
+    int node = nodeAt(event->pos());
+    if (node != -1 && !callTree->getSource(node).isEmpty()) {
+        emit sourceActivated(callTree->getSource(node));
+    }
+}
+
+int FlameGraph::nodeAt(const QPoint& pos) const {
+    if (!callTree || !callTree->getSampleCount() || pos.y() < 0) return -1;
+
+    int depth = pos.y() / ROW_HEIGHT;
+    int current = zoomNode;
+    double x = 0;
+    double frameWidth = width();
+
+    for (int i = 0; i < depth && current != -1; i++) {
+        const CallTree::Node& node = callTree->getNode(current);
+        int found = -1;
+
+        for (int child = node.firstChild; child != -1; child = callTree->getNode(child).nextSibling) {
+            double childWidth = frameWidth * callTree->getNode(child).total / node.total;
+            if (pos.x() >= x && pos.x() < x + childWidth) {
+                found = child;
+                frameWidth = childWidth;
+                break;
+            }
+            x += childWidth;
+        }
+
+        current = found;
+    }
+
+    return current;
+}
+
+int FlameGraph::getDepth(int node) const {
+    int depth = 0;
+    QVector<QPair<int, int>> nodes;
+    nodes.append(qMakePair(node, 0));
+
+    while (!nodes.isEmpty()) {
+        QPair<int, int> item = nodes.takeLast();
+        depth = qMax(depth, item.second);
+
+        for (int child = callTree->getNode(item.first).firstChild; child != -1; child = callTree->getNode(child).nextSibling) {
+            nodes.append(qMakePair(child, item.second + 1));
+        }
+    }
+
+    return depth;
+}
+
+QColor FlameGraph::getColor(int node) const {
+    if (searching && matches.at(node)) {
+        return QColor(230, 0, 230);
+    }
+
+    // Warm palette, stable for a given function name.
+    uint hash = qHash(callTree->getName(node));
+    return QColor::fromHsv(static_cast<int>(hash % 50), 130 + static_cast<int>(hash / 50 % 80), 235);
+}
+
+void FlameGraph::updateHeight() {
+    int rows = callTree ? getDepth(zoomNode) + 1 : 0;
+    setMinimumHeight(rows * ROW_HEIGHT);
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "Process/CallTree.h"
+#include <QWidget>
+#include <QSharedPointer>
+
+// Icicle graph of a call tree: callers on top, callees below,
+// widths proportional to sample counts.
+class FlameGraph : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit FlameGraph(QWidget* parent = nullptr);
+
+    void setCallTree(const QSharedPointer<CallTree>& callTree);
+    void clearCallTree();
+
+    void setSearchText(const QString& text);
+    void zoomTo(int node);
+    void zoomOut();
+    void resetZoom();
+
+signals:
+    void zoomChanged(const QString& path);
+    void searchMatched(qint64 samples, qint64 total);
+    void sourceActivated(const QString& source);
+
+protected:
+    bool event(QEvent* event) override;
+    void paintEvent(QPaintEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+
+private:
+    int nodeAt(const QPoint& pos) const;
+    int getDepth(int node) const;
+    QColor getColor(int node) const;
+    void updateHeight();
+
+    QSharedPointer<CallTree> callTree;
+    int zoomNode = CallTree::ROOT;
+    QVector<bool> matches;
+    bool searching = false;
+};
@@ -0,0 +1,56 @@
+#include "FlameGraphView.h"
+#include "FlameGraph.h"
+#include <QtWidgets>
+
+FlameGraphView::FlameGraphView(QWidget* parent) : QWidget(parent) {
+    flameGraph = new FlameGraph;
+    connect(flameGraph, &FlameGraph::sourceActivated, this, &FlameGraphView::sourceActivated);
+
+    searchLineEdit = new QLineEdit;
+    searchLineEdit->setPlaceholderText(tr("Search functions"));
+    searchLineEdit->setClearButtonEnabled(true);
+    searchLineEdit->setMaximumWidth(250);
+    connect(searchLineEdit, &QLineEdit::textChanged, flameGraph, &FlameGraph::setSearchText);
+
+    QPushButton* resetButton = new QPushButton(tr("Reset Zoom"));
+    connect(resetButton, &QPushButton::clicked, flameGraph, &FlameGraph::resetZoom);
+
+    pathLabel = new QLabel;
+    pathLabel->setToolTip(tr("Click a frame to zoom in, right click to zoom out, double click to open its source"));
+    connect(flameGraph, &FlameGraph::zoomChanged, [=] (const QString& path) {
+        pathLabel->setText(pathLabel->fontMetrics().elidedText(path, Qt::ElideLeft, qMax(100, pathLabel->width())));
+    });
+
+    matchLabel = new QLabel;
+    connect(flameGraph, &FlameGraph::searchMatched, [=] (qint64 samples, qint64 total) {
+        matchLabel->setText(total ? tr("Matched: %1%").arg(100.0 * samples / total, 0, 'f', 2) : QString());
+    });
+
+    QHBoxLayout* toolLayout = new QHBoxLayout;
+    toolLayout->addWidget(searchLineEdit);
+    toolLayout->addWidget(matchLabel);
+    toolLayout->addWidget(pathLabel, 1);
+    toolLayout->addWidget(resetButton);
+
+    QScrollArea* scrollArea = new QScrollArea;
+    scrollArea->setFrameShape(QFrame::NoFrame);
+    scrollArea->setWidgetResizable(true);
+    scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+    scrollArea->setWidget(flameGraph);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 0, 0);
+    layout->addLayout(toolLayout);
+    layout->addWidget(scrollArea);
+}
+
+void FlameGraphView::setCallTree(const QSharedPointer<CallTree>& callTree) {
+    flameGraph->setCallTree(callTree);
+    flameGraph->setSearchText(searchLineEdit->text());
+}
+
+void FlameGraphView::clearCallTree() {
+    flameGraph->clearCallTree();
+    pathLabel->clear();
+    matchLabel->clear();
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "Process/CallTree.h"
+#include <QWidget>
+#include <QSharedPointer>
+
+class FlameGraph;
+class QLabel;
+class QLineEdit;
+
+class FlameGraphView : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit FlameGraphView(QWidget* parent = nullptr);
+
+    void setCallTree(const QSharedPointer<CallTree>& callTree);
+    void clearCallTree();
+
+signals:
+    void sourceActivated(const QString& source);
+
+private:
+    FlameGraph* flameGraph;
+    QLineEdit* searchLineEdit;
+    QLabel* pathLabel;
+    QLabel* matchLabel;
+};
@@ -0,0 +1,93 @@
+#include "HeapProfileModel.h"
+#include <QtGui>
+
+static QString formatBytes(qint64 bytes) {
+    if (bytes < 1024) return QString("%1 B").arg(bytes);
+    if (bytes < 1024 * 1024) return QString("%1 KiB").arg(bytes / 1024.0, 0, 'f', 1);
+    if (bytes < 1024 * 1024 * 1024) return QString("%1 MiB").arg(bytes / (1024.0 * 1024), 0, 'f', 1);
+    return QString("%1 GiB").arg(bytes / (1024.0 * 1024 * 1024), 0, 'f', 2);
+}
+
+HeapProfileModel::HeapProfileModel(QObject* parent) : QAbstractItemModel(parent) {
+}
+
+void HeapProfileModel::setProfile(const QSharedPointer<HeapProfile>& profile) {
+    beginResetModel();
+    this->profile = profile;
+    endResetModel();
+}
+
+int HeapProfileModel::getNode(const QModelIndex& index) const {
+    return index.isValid() ? static_cast<int>(index.internalId()) : HeapProfile::ROOT;
+}
+
+QModelIndex HeapProfileModel::index(int row, int column, const QModelIndex& parent) const {
+    if (!hasIndex(row, column, parent)) return QModelIndex();
+    return createIndex(row, column, static_cast<quintptr>(profile->getChild(getNode(parent), row)));
+}
+
+QModelIndex HeapProfileModel::parent(const QModelIndex& index) const {
+    if (!index.isValid()) return QModelIndex();
+
+    int parent = profile->getNode(getNode(index)).parent;
+    if (parent == HeapProfile::ROOT) return QModelIndex();
+
+    return createIndex(profile->getNode(parent).row, 0, static_cast<quintptr>(parent));
+}
+
+int HeapProfileModel::rowCount(const QModelIndex& parent) const {
+    if (!profile || parent.column() > 0) return 0;
+    return profile->getNode(getNode(parent)).childCount;
+}
+
+int HeapProfileModel::columnCount(const QModelIndex& parent) const {
+    Q_UNUSED(parent)
+    return ColumnCount;
+}
+
+QVariant HeapProfileModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid()) return QVariant();
+
+    int node = getNode(index);
+    const HeapProfile::Node& data = profile->getNode(node);
+    bool dhat = profile->getFormat() == HeapProfile::Format::Dhat;
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+            case FrameColumn: {
+                // Addresses only matter in the tooltip.
+                static const QRegularExpression addressRegExp("^0x[0-9A-Fa-f]+: ");
+                return profile->getFrame(node).remove(addressRegExp);
+            }
+            case BytesColumn:
+                return formatBytes(data.bytes);
+            case BlocksColumn:
+                return dhat ? QVariant(data.blocks) : QVariant();
+            case LifetimeColumn:
+                return dhat && data.blocks ? QVariant(QString("%1 %2").arg(data.lifetime / data.blocks).arg(profile->getTimeUnit())) : QVariant();
+            case PeakColumn:
+                return formatBytes(data.peakBytes);
+            default:
+                break;
+        }
+    } else if (role == Qt::ToolTipRole && index.column() == FrameColumn) {
+        return profile->getFrame(node);
+    } else if (role == Qt::TextAlignmentRole && index.column() != FrameColumn) {
+        return static_cast<int>(Qt::AlignRight | Qt::AlignVCenter);
+    }
+
+    return QVariant();
+}
+
+QVariant HeapProfileModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+
+    switch (section) {
+        case FrameColumn: return tr("Allocation Site");
+        case BytesColumn: return tr("Total");
+        case BlocksColumn: return tr("Blocks");
+        case LifetimeColumn: return tr("Avg Lifetime");
+        case PeakColumn: return tr("At Peak");
+        default: return QVariant();
+    }
+}
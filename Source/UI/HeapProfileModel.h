@@ -0,0 +1,34 @@
+#pragma once
+#include "Process/HeapProfile.h"
+#include <QAbstractItemModel>
+#include <QSharedPointer>
+
+class HeapProfileModel : public QAbstractItemModel {
+    Q_OBJECT
+
+public:
+    enum Columns {
+        FrameColumn,
+        BytesColumn,
+        BlocksColumn,
+        LifetimeColumn,
+        PeakColumn,
+        ColumnCount
+    };
+
+    explicit HeapProfileModel(QObject* parent = nullptr);
+
+    void setProfile(const QSharedPointer<HeapProfile>& profile);
+    const HeapProfile* getProfile() const { return profile.data(); }
+    int getNode(const QModelIndex& index) const;
+
+    QModelIndex index(int row, int column, const QModelIndex& parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex& index) const override;
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    QSharedPointer<HeapProfile> profile;
+};
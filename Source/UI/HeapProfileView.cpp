@@ -0,0 +1,100 @@
+#include "HeapProfileView.h"
+#include "HeapProfileModel.h"
+#include <QtWidgets>
+
+class HeapProfileLoader : public QRunnable {
+public:
+    HeapProfileLoader(HeapProfileView* view, int request, const QString& filePath, QSharedPointer<HeapProfile> profile) :
+            view(view),
+            request(request),
+            filePath(filePath),
+            profile(profile) {
+    }
+
+    void run() override {
+        bool result = profile->load(filePath);
+        emit view->loadFinished(request, filePath, result);
+    }
+
+private:
+    HeapProfileView* view;
+    int request;
+    QString filePath;
+    QSharedPointer<HeapProfile> profile;
+};
+
+HeapProfileView::HeapProfileView(QWidget* parent) : QWidget(parent) {
+    pool = new QThreadPool(this);
+    pool->setMaxThreadCount(1);
+    connect(this, &HeapProfileView::loadFinished, this, &HeapProfileView::onLoadFinished, Qt::QueuedConnection);
+
+    heapProfileModel = new HeapProfileModel(this);
+
+    summaryLabel = new QLabel;
+    summaryLabel->setTextInteractionFlags(Qt::TextSelectableByMouse);
+
+    treeView = new QTreeView;
+    treeView->setFrameShape(QFrame::NoFrame);
+    treeView->setUniformRowHeights(true);
+    treeView->setModel(heapProfileModel);
+    treeView->header()->setSectionResizeMode(HeapProfileModel::FrameColumn, QHeaderView::Stretch);
+    treeView->header()->setStretchLastSection(false);
+
+    connect(treeView, &QTreeView::activated, [=] (const QModelIndex& index) {
+        QString filePath;
+        int line = 0;
+        int column = 0;
+        QString frame = heapProfileModel->getProfile()->getFrame(heapProfileModel->getNode(index));
+        if (HeapProfile::parseLocation(frame, filePath, line, column)) {
+            emit locationActivated(filePath, line, column);
+        }
+    });
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->setContentsMargins(4, 4, 0, 0);
+    layout->addWidget(summaryLabel);
+    layout->addWidget(treeView);
+}
+
+HeapProfileView::~HeapProfileView() {
+    // Loaders emit on this object.
+    pool->waitForDone();
+}
+
+void HeapProfileView::loadProfile(const QString& filePath) {
+    loadRequest++;
+    loadingProfile.reset(new HeapProfile);
+    summaryLabel->setText(tr("Loading %1...").arg(QFileInfo(filePath).fileName()));
+    pool->start(new HeapProfileLoader(this, loadRequest, filePath, loadingProfile));
+}
+
+void HeapProfileView::onLoadFinished(int request, const QString& filePath, bool result) {
+    if (request != loadRequest) return;
+
+    QSharedPointer<HeapProfile> profile = loadingProfile;
+    loadingProfile.reset();
+
+    if (!result) {
+        summaryLabel->clear();
+        QMessageBox::warning(this, tr("Open Heap Profile"), tr("Failed to load %1: %2").arg(filePath, profile->getErrorString()));
+        return;
+    }
+
+    heapProfileModel->setProfile(profile);
+
+    const HeapProfile::Node& root = profile->getNode(HeapProfile::ROOT);
+    QString format = profile->getFormat() == HeapProfile::Format::Dhat ? "DHAT" : "massif";
+    summaryLabel->setText(tr("%1 (%2): %3 bytes in %4 blocks, %5 bytes at peak")
+            .arg(profile->getCommand(), format)
+            .arg(root.bytes)
+            .arg(root.blocks)
+            .arg(root.peakBytes));
+}
+
+void HeapProfileView::clearProfile() {
+    // A running load is dropped.
+    loadRequest++;
+    loadingProfile.reset();
+    heapProfileModel->setProfile(QSharedPointer<HeapProfile>());
+    summaryLabel->clear();
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include <QWidget>
+#include <QSharedPointer>
+
+class HeapProfile;
+class HeapProfileModel;
+class QLabel;
+class QTreeView;
+class QThreadPool;
+
+class HeapProfileView : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit HeapProfileView(QWidget* parent = nullptr);
+    ~HeapProfileView();
+
+    // Profiles can be hundreds of megabytes, they are parsed on a pool thread.
+    void loadProfile(const QString& filePath);
+    void clearProfile();
+
+signals:
+    void locationActivated(const QString& filePath, int line, int column);
+    // Delivers the result of a load from the pool to the view's thread.
+    void loadFinished(int request, const QString& filePath, bool result);
+
+private slots:
+    void onLoadFinished(int request, const QString& filePath, bool result);
+
+private:
+    QThreadPool* pool;
+    int loadRequest = 0;
+    QSharedPointer<HeapProfile> loadingProfile;
+
+    HeapProfileModel* heapProfileModel;
+    QLabel* summaryLabel;
+    QTreeView* treeView;
+};
@@ -0,0 +1,60 @@
+#include "IssueList.h"
+#include <QtWidgets>
+
+enum Columns {
+    DescriptionColumn,
+    LocationColumn
+};
+
+enum Roles {
+    FilePathRole = Qt::UserRole,
+    LineRole,
+    ColumnRole
+};
+
+IssueList::IssueList(QWidget* parent) : QTreeWidget(parent) {
+    setFrameShape(QFrame::NoFrame);
+    setRootIsDecorated(false);
+    setUniformRowHeights(true);
+    setHeaderLabels(QStringList() << tr("Description") << tr("Location"));
+    header()->setSectionResizeMode(DescriptionColumn, QHeaderView::Stretch);
+    header()->setStretchLastSection(false);
+
+    connect(this, &QTreeWidget::itemActivated, this, &IssueList::onItemActivated);
+}
+
+void IssueList::setDiagnostics(const QVector<CargoManager::Diagnostic>& diagnostics) {
+    clear();
+
+    QList<QTreeWidgetItem*> items;
+
+    for (const CargoManager::Diagnostic& diagnostic : diagnostics) {
+        QTreeWidgetItem* item = new QTreeWidgetItem;
+        item->setText(DescriptionColumn, diagnostic.level + ": " + diagnostic.message);
+        item->setText(LocationColumn, QString("%1:%2:%3")
+                .arg(QFileInfo(diagnostic.filePath).fileName())
+                .arg(diagnostic.line)
+                .arg(diagnostic.column));
+        item->setToolTip(DescriptionColumn, diagnostic.rendered);
+        item->setToolTip(LocationColumn, diagnostic.filePath);
+        item->setData(0, FilePathRole, diagnostic.filePath);
+        item->setData(0, LineRole, diagnostic.line);
+        item->setData(0, ColumnRole, diagnostic.column);
+
+        if (diagnostic.level == "error") {
+            item->setForeground(DescriptionColumn, QColor("#cd3131"));
+        } else if (diagnostic.level == "warning") {
+            item->setForeground(DescriptionColumn, QColor("#949800"));
+        }
+
+        items.append(item);
+    }
+
+    addTopLevelItems(items);
+}
+
+void IssueList::onItemActivated(QTreeWidgetItem* item) {
+    emit locationActivated(item->data(0, FilePathRole).toString(),
+                           item->data(0, LineRole).toInt(),
+                           item->data(0, ColumnRole).toInt());
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include "Process/CargoManager.h"
+#include <QTreeWidget>
+
+class IssueList : public QTreeWidget {
+    Q_OBJECT
+
+public:
+    explicit IssueList(QWidget* parent = nullptr);
+
+    void setDiagnostics(const QVector<CargoManager::Diagnostic>& diagnostics);
+
+signals:
+    void locationActivated(const QString& filePath, int line, int column);
+
+private slots:
+    void onItemActivated(QTreeWidgetItem* item);
+};
@@ -3,16 +3,34 @@
 #include "Core/Global.h"
 #include "Core/Constants.h"
 #include "Core/Settings.h"
+#include "Core/Preferences.h"
+#include "Core/ProjectWatcher.h"
+#include "Core/Trace.h"
+#include "Core/FileIndex.h"
+#include "Core/IgnoreMatcher.h"
 #include "NewProject.h"
 #include "GoToLine.h"
+#include "QuickOpen.h"
 #include "Options.h"
 #include "Process/CargoManager.h"
+#include "Process/JobScheduler.h"
+#include "Process/TestManager.h"
+#include "Process/ProfileManager.h"
 #include "ProjectTree.h"
 #include "ProjectProperties.h"
 #include "TextEditor/TextEditor.h"
 #include "TextEditor/AutoCompleter.h"
 #include "TextEditor/SyntaxHighlightManager.h"
+#include "TextEditor/DocumentRegistry.h"
 #include "NewName.h"
+#include "ConsoleOutput.h"
+#include "IssueList.h"
+#include "TestExplorer.h"
+#include "BuildTimingsView.h"
+#include "BenchmarkView.h"
+#include "FlameGraphView.h"
+#include "HeapProfileView.h"
+#include "CodegenView.h"
 #ifdef Q_OS_WIN
     #include <windows.h>
 #endif
@@ -20,16 +38,30 @@
 
 MainWindow::MainWindow() :
         ui(new Ui::MainWindow) {
+    TRACE_SCOPE("MainWindow::MainWindow");
     new SyntaxHighlightManager(this);
+    new DocumentRegistry(this);
+    new JobScheduler(this);
 
     ui->setupUi(this);
 
+    // Split views go next to the tabs.
+    splitterSource = new QSplitter(Qt::Horizontal);
+    splitterSource->setChildrenCollapsible(false);
+    ui->splitterSide->insertWidget(0, splitterSource);
+    splitterSource->addWidget(ui->tabWidgetSource);
+
     projectProperties = new ProjectProperties;
 
     cargoManager = new CargoManager(projectProperties, this);
     connect(cargoManager, &CargoManager::projectCreated, this, &MainWindow::onProjectCreated);
     connect(cargoManager, &CargoManager::consoleMessage, this, &MainWindow::onCargoMessage);
 
+    ui->plainTextEditCargo->setPathResolver([=] (const QString& filePath) {
+        return resolveSourcePath(filePath);
+    });
+    connect(ui->plainTextEditCargo, &ConsoleOutput::locationActivated, this, &MainWindow::openLocation);
+
     projectTree = new ProjectTree;
     connect(projectTree, &ProjectTree::openActivated, this, &MainWindow::addSourceTab);
     connect(projectTree, &ProjectTree::newFileActivated, this, &MainWindow::onFileCreated);
@@ -39,6 +71,99 @@ MainWindow::MainWindow() :
     ui->tabWidgetSide->addTab(projectTree, tr("Project"));
     ui->tabWidgetSide->addTab(projectProperties, tr("Properties"));
 
+    issueList = new IssueList;
+    connect(issueList, &IssueList::locationActivated, this, &MainWindow::openLocation);
+    ui->tabWidgetOutput->addTab(issueList, tr("Issues"));
+
+    connect(cargoManager, &CargoManager::checkFinished, [=] (const QVector<CargoManager::Diagnostic>& diagnostics) {
+        issueList->setDiagnostics(diagnostics);
+        int index = static_cast<int>(OutputPane::Issues);
+        ui->tabWidgetOutput->setTabText(index, diagnostics.isEmpty() ? tr("Issues") : tr("Issues (%1)").arg(diagnostics.count()));
+    });
+
+    testManager = new TestManager(projectProperties, this);
+    testExplorer = new TestExplorer;
+    ui->tabWidgetOutput->addTab(testExplorer, tr("Tests"));
+
+    connect(testManager, &TestManager::consoleMessage, [=] (const QString& message) {
+        ui->plainTextEditCargo->appendMessage(message);
+    });
+    connect(testManager, &TestManager::testsListed, testExplorer, &TestExplorer::setTests);
+    connect(testManager, &TestManager::testStarted, testExplorer, &TestExplorer::onTestStarted);
+    connect(testManager, &TestManager::testFinished, testExplorer, &TestExplorer::onTestFinished);
+    connect(testManager, &TestManager::testOutput, testExplorer, &TestExplorer::onTestOutput);
+    connect(testManager, &TestManager::runFinished, [=] (int passed, int failed, int ignored, qint64 elapsed) {
+        int index = static_cast<int>(OutputPane::Tests);
+        ui->tabWidgetOutput->setTabText(index, tr("Tests (%1 passed, %2 failed)").arg(passed).arg(failed));
+        ui->tabWidgetOutput->setTabToolTip(index, tr("%1 passed, %2 failed, %3 ignored in %4 s")
+                .arg(passed).arg(failed).arg(ignored).arg(elapsed / 1000.0, 0, 'f', 2));
+        updateMenuState();
+    });
+
+    buildTimingsView = new BuildTimingsView;
+    ui->tabWidgetOutput->addTab(buildTimingsView, tr("Timings"));
+    connect(cargoManager, &CargoManager::timingsReady, this, &MainWindow::onTimingsReady);
+
+    benchmarkView = new BenchmarkView;
+    ui->tabWidgetOutput->addTab(benchmarkView, tr("Benchmarks"));
+    connect(cargoManager, &CargoManager::benchFinished, [=] (const QString& criterionPath) {
+        benchmarkView->setCriterionPath(criterionPath);
+        ui->tabWidgetOutput->setCurrentIndex(static_cast<int>(OutputPane::Benchmarks));
+    });
+
+    profileManager = new ProfileManager(projectProperties, this);
+    connect(profileManager, &ProfileManager::consoleMessage, this, &MainWindow::onCargoMessage);
+
+    flameGraphView = new FlameGraphView;
+    ui->tabWidgetOutput->addTab(flameGraphView, tr("Profile"));
+    connect(profileManager, &ProfileManager::profileReady, [=] (QSharedPointer<CallTree> callTree) {
+        flameGraphView->setCallTree(callTree);
+        ui->tabWidgetOutput->setCurrentIndex(static_cast<int>(OutputPane::Profile));
+    });
+    connect(flameGraphView, &FlameGraphView::sourceActivated, [=] (const QString& source) {
+        // file.rs:12, relative paths come from the project's own crates.
+        int separator = source.lastIndexOf(':');
+        if (separator > 0) {
+            openLocation(resolveSourcePath(source.left(separator)), source.mid(separator + 1).toInt(), 1);
+        }
+    });
+
+    heapProfileView = new HeapProfileView;
+    ui->tabWidgetOutput->addTab(heapProfileView, tr("Heap"));
+    connect(heapProfileView, &HeapProfileView::locationActivated, [=] (const QString& filePath, int line, int column) {
+        openLocation(resolveSourcePath(filePath), line, column);
+    });
+
+    codegenView = new CodegenView;
+    ui->tabWidgetOutput->addTab(codegenView, tr("Codegen"));
+    connect(codegenView, &CodegenView::emitRequested, cargoManager, &CargoManager::emitCode);
+    connect(cargoManager, &CargoManager::codegenEmitted, codegenView, &CodegenView::setOutput);
+    connect(codegenView, &CodegenView::locationActivated, this, &MainWindow::openLocation);
+
+    // Coalesce saves (e.g. Save All) into a single check.
+    checkTimer = new QTimer(this);
+    checkTimer->setSingleShot(true);
+    checkTimer->setInterval(500);
+    connect(checkTimer, &QTimer::timeout, [=] {
+        if (!projectPath.isEmpty()) {
+            cargoManager->check();
+        }
+    });
+
+    projectWatcher = new ProjectWatcher(this);
+    connect(projectWatcher, &ProjectWatcher::changed, cargoManager, &CargoManager::watch);
+    connect(projectProperties, &ProjectProperties::metadataChanged, [=] {
+        projectWatcher->setMetadata(projectProperties->getMetadata());
+        codegenView->setPackagePaths(projectProperties->getLocalPackagePaths());
+    });
+
+    fileIndex = new FileIndex(this);
+
+    hibernateTimer = new QTimer(this);
+    hibernateTimer->setInterval(Constants::HIBERNATE_INTERVAL);
+    connect(hibernateTimer, &QTimer::timeout, this, &MainWindow::hibernateTabs);
+    hibernateTimer->start();
+
     int id = QFontDatabase::addApplicationFont(":/Resources/Font/FontAwesome/Font-Awesome-5-Free-Solid-900.otf");
     if (id < 0) {
         qWarning() << "Failed to load FontAwesome!";
@@ -70,6 +195,8 @@ MainWindow::MainWindow() :
 }
 
 MainWindow::~MainWindow() {
+    // Editors release their documents, the registry is destroyed before the widgets.
+    on_actionCloseAll_triggered();
     delete ui;
 }
 
@@ -174,6 +301,13 @@ void MainWindow::on_actionOpen_triggered() {
     }
 }
 
+void MainWindow::on_actionGoToFile_triggered() {
+    QuickOpen quickOpen(fileIndex, this);
+    if (quickOpen.exec() == QDialog::Accepted) {
+        addSourceTab(quickOpen.getFilePath());
+    }
+}
+
 void MainWindow::on_actionSave_triggered() {
     editor->saveFile();
 }
@@ -252,24 +386,123 @@ void MainWindow::on_actionBuild_triggered() {
     cargoManager->build();
 }
 
+void MainWindow::on_actionBuildWithTimings_triggered() {
+    on_actionSaveAll_triggered();
+    cargoManager->buildWithTimings();
+}
+
 void MainWindow::on_actionRun_triggered() {
     on_actionSaveAll_triggered();
     cargoManager->run();
 }
 
+void MainWindow::on_actionTest_triggered() {
+    on_actionSaveAll_triggered();
+    ui->tabWidgetOutput->setCurrentIndex(static_cast<int>(OutputPane::Tests));
+    ui->tabWidgetOutput->setTabText(static_cast<int>(OutputPane::Tests), tr("Tests"));
+    testManager->runAll();
+}
+
+void MainWindow::on_actionTestFailed_triggered() {
+    on_actionSaveAll_triggered();
+    ui->tabWidgetOutput->setCurrentIndex(static_cast<int>(OutputPane::Tests));
+    testManager->runFailed();
+}
+
+void MainWindow::on_actionBench_triggered() {
+    on_actionSaveAll_triggered();
+    cargoManager->bench();
+}
+
+void MainWindow::on_actionProfileRun_triggered() {
+    on_actionSaveAll_triggered();
+    profileManager->profile();
+}
+
+void MainWindow::on_actionShowAssembly_triggered() {
+    showCodegen(CodegenIndex::Kind::Assembly);
+}
+
+void MainWindow::on_actionShowLlvmIr_triggered() {
+    showCodegen(CodegenIndex::Kind::LlvmIr);
+}
+
+void MainWindow::on_actionWatch_toggled(bool checked) {
+    if (checked && !projectPath.isEmpty()) {
+        projectWatcher->setProjectPath(projectPath);
+        cargoManager->watch();
+    } else {
+        projectWatcher->setProjectPath(QString());
+        cargoManager->cancelWatch();
+    }
+}
+
+void MainWindow::on_actionNextLocation_triggered() {
+    ui->tabWidgetOutput->setCurrentIndex(static_cast<int>(OutputPane::Cargo));
+    ui->plainTextEditCargo->nextLocation();
+}
+
+void MainWindow::on_actionPreviousLocation_triggered() {
+    ui->tabWidgetOutput->setCurrentIndex(static_cast<int>(OutputPane::Cargo));
+    ui->plainTextEditCargo->previousLocation();
+}
+
 void MainWindow::on_actionStop_triggered() {
     cargoManager->stop();
+    testManager->stop();
+    profileManager->stop();
 }
 
 void MainWindow::on_actionClean_triggered() {
     cargoManager->clean();
 }
 
+void MainWindow::on_actionOpenHeapProfile_triggered() {
+    QString filePath = QFileDialog::getOpenFileName(this, tr("Open Heap Profile"), projectPath,
+            "DHAT (*.json);;Massif (massif.out.*);;All Files(*.*)");
+
+    if (!filePath.isEmpty()) {
+        heapProfileView->loadProfile(filePath);
+        ui->tabWidgetOutput->setCurrentIndex(static_cast<int>(OutputPane::Heap));
+    }
+}
+
 void MainWindow::on_actionOptions_triggered() {
     Options options(this);
     options.exec();
 }
 
+void MainWindow::on_actionSplitEditor_toggled(bool checked) {
+    if (checked && !splitEditor && editor) {
+        splitEditor = new TextEditor(editor->getFilePath());
+        splitEditor->setCursorPosition(editor->getCursorPosition());
+        connect(splitEditor, &TextEditor::documentModified, this, &MainWindow::onDocumentModified);
+        connect(splitEditor, &TextEditor::fileSaved, this, &MainWindow::onFileSaved);
+        connect(splitEditor, &TextEditor::focusChanged, this, [=] (bool focus) {
+            if (focus) {
+                editor = splitEditor;
+                editor->setAutoCompleter(completer);
+            }
+        });
+
+        splitterSource->addWidget(splitEditor);
+        splitEditor->setFocus();
+    } else if (!checked && splitEditor) {
+        if (editor == splitEditor) {
+            int index = ui->tabWidgetSource->currentIndex();
+            editor = index >= 0 ? static_cast<TextEditor*>(ui->tabWidgetSource->widget(index)) : nullptr;
+            if (editor) {
+                editor->setAutoCompleter(completer);
+            }
+        }
+
+        delete splitEditor;
+        splitEditor = nullptr;
+    }
+
+    updateMenuState();
+}
+
 void MainWindow::on_actionAbout_triggered() {
     QMessageBox::about(this, tr("About %1").arg(Constants::APP_NAME),
         tr("<h3>%1 %2 %3</h3>\
@@ -285,6 +518,12 @@ void MainWindow::on_actionAbout_triggered() {
 
 void MainWindow::on_tabWidgetSource_tabCloseRequested(int index) {
     QWidget* widget = ui->tabWidgetSource->widget(index);
+
+    // A split view doesn't outlive the tab of its file.
+    if (splitEditor && static_cast<TextEditor*>(widget)->document() == splitEditor->document()) {
+        ui->actionSplitEditor->setChecked(false);
+    }
+
     ui->tabWidgetSource->removeTab(index);
     delete widget;
 }
@@ -297,6 +536,8 @@ void MainWindow::on_tabWidgetSource_currentChanged(int index) {
         QString filePath = editor->getFilePath();
         projectTree->selectFile(filePath);
         changeWindowTitle(filePath);
+        // The activated tab may have pushed the others over the budget.
+        hibernateTabs();
     } else {
         editor = nullptr;
         projectTree->setCurrentIndex(QModelIndex());
@@ -315,43 +556,85 @@ void MainWindow::on_toolButtonCargoRun_clicked() {
 }
 
 void MainWindow::on_toolButtonCargoClear_clicked() {
-    ui->plainTextEditCargo->clear();
+    ui->plainTextEditCargo->clearOutput();
 }
 
 void MainWindow::on_toolButtonCargoStop_clicked() {
     cargoManager->stop();
+    testManager->stop();
+    profileManager->stop();
 }
 
 void MainWindow::onProjectCreated(const QString& path) {
     openProject(path, true);
 }
 
-void MainWindow::onCargoMessage(const QString& message, bool html, bool start) {
+void MainWindow::onTimingsReady(const QString& reportPath) {
+    BuildTimings timings;
+    if (!timings.load(reportPath)) return;
+
+    QString historyPath = projectPath + "/" + Constants::PROJECT_DATA_DIRECTORY + "/" + Constants::PROJECT_TIMINGS_FILE;
+    QVector<BuildTimings::HistoryEntry> history = BuildTimings::loadHistory(historyPath);
+    buildTimingsView->setTimings(timings, history.isEmpty() ? nullptr : &history.last());
+    timings.appendToHistory(historyPath);
+
+    ui->tabWidgetOutput->setCurrentIndex(static_cast<int>(OutputPane::Timings));
+}
+
+void MainWindow::onCargoMessage(const QString& message, bool start) {
     int index = static_cast<int>(OutputPane::Cargo);
     ui->tabWidgetOutput->setCurrentIndex(index);
 
     if (start) {
-        ui->plainTextEditCargo->clear();
+        ui->plainTextEditCargo->clearOutput();
     }
 
-    if (html) {
-        ui->plainTextEditCargo->appendHtml(message);
-    } else {
-        ui->plainTextEditCargo->insertPlainText(message);
-    }
-
-    ui->plainTextEditCargo->verticalScrollBar()->setValue(ui->plainTextEditCargo->verticalScrollBar()->maximum());
+    ui->plainTextEditCargo->appendMessage(message);
 }
 
 void MainWindow::onFileCreated(const QString& filePath) {
     addNewFile(filePath);
 }
 
+void MainWindow::hibernateTabs() {
+    TRACE_SCOPE("MainWindow::hibernateTabs");
+    const Preferences::Editor& preferences = Preferences::getInstance()->getEditor();
+    qint64 idleTime = qint64(preferences.hibernateIdleMinutes) * 60 * 1000;
+    qint64 budget = qint64(preferences.hibernateMemoryBudget) * 1024 * 1024;
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    DocumentRegistry* documentRegistry = DocumentRegistry::getInstance();
+    qint64 usage = documentRegistry->getMemoryUsage();
+
+    QVector<TextEditor*> candidates;
+    for (int i = 0; i < ui->tabWidgetSource->count(); i++) {
+        TextEditor* editor = static_cast<TextEditor*>(ui->tabWidgetSource->widget(i));
+        if (editor->isLoaded() && !editor->isVisible() && !editor->document()->isModified()) {
+            candidates.append(editor);
+        }
+    }
+
+    // Least recently used first.
+    std::sort(candidates.begin(), candidates.end(), [] (TextEditor* a, TextEditor* b) {
+        return a->getLastActive() < b->getLastActive();
+    });
+
+    for (TextEditor* editor : candidates) {
+        bool idle = idleTime > 0 && now - editor->getLastActive() > idleTime;
+        bool overBudget = budget > 0 && usage > budget;
+        if (!idle && !overBudget) continue;
+
+        qint64 size = documentRegistry->getMemoryUsage(editor);
+        if (editor->unload()) {
+            usage -= size;
+        }
+    }
+}
+
 void MainWindow::onFileRemoved(const QString& filePath) {
     QVector<int> indices;
     for (int i = 0; i < ui->tabWidgetSource->count(); i++) {
         TextEditor* editor = static_cast<TextEditor*>(ui->tabWidgetSource->widget(i));
-        if (editor->getFilePath().contains(filePath)) {
+        if (isPathInside(editor->getFilePath(), filePath)) {
             indices.append(i);
         }
     }
@@ -365,10 +648,10 @@ void MainWindow::onFileRemoved(const QString& filePath) {
 void MainWindow::onFileRenamed(const QString& oldPath, const QString& newPath) {
     for (int i = 0; i < ui->tabWidgetSource->count(); i++) {
         TextEditor* editor = static_cast<TextEditor*>(ui->tabWidgetSource->widget(i));
-        if (editor->getFilePath().contains(oldPath)) {
+        if (isPathInside(editor->getFilePath(), oldPath)) {
             QFileInfo fi(newPath);
             if (fi.isDir()) {
-                editor->setFilePath(editor->getFilePath().replace(oldPath, newPath));
+                editor->setFilePath(newPath + editor->getFilePath().mid(oldPath.size()));
             } else {
                 editor->setFilePath(newPath);
                 onDocumentModified(editor);
@@ -383,11 +666,7 @@ int MainWindow::addSourceTab(const QString& filePath) {
         ui->tabWidgetSource->setCurrentIndex(tabIndex);
         return tabIndex;
     } else {
-        QFileInfo fi(filePath);
-        TextEditor* editor = new TextEditor(filePath);
-        connect(editor, &TextEditor::documentModified, this, &MainWindow::onDocumentModified);
-        int index = ui->tabWidgetSource->addTab(editor, fi.fileName());
-        ui->tabWidgetSource->setTabToolTip(index, filePath);
+        int index = createSourceTab(filePath);
         ui->tabWidgetSource->setCurrentIndex(index);
 
         addRecentFile(filePath);
@@ -396,6 +675,33 @@ int MainWindow::addSourceTab(const QString& filePath) {
     }
 }
 
+int MainWindow::createSourceTab(const QString& filePath) {
+    QFileInfo fi(filePath);
+    TextEditor* editor = new TextEditor(filePath);
+    connect(editor, &TextEditor::documentModified, this, &MainWindow::onDocumentModified);
+    connect(editor, &TextEditor::fileSaved, this, &MainWindow::onFileSaved);
+    connect(editor, &TextEditor::focusChanged, this, [=] (bool focus) {
+        // Back from the split view.
+        if (focus && this->editor != editor) {
+            this->editor = editor;
+            editor->setAutoCompleter(completer);
+        }
+    });
+    int index = ui->tabWidgetSource->addTab(editor, fi.fileName());
+    ui->tabWidgetSource->setTabToolTip(index, filePath);
+
+    return index;
+}
+
+void MainWindow::openLocation(const QString& filePath, int line, int column) {
+    if (!QFileInfo::exists(filePath)) return;
+
+    int index = addSourceTab(filePath);
+    TextEditor* editor = static_cast<TextEditor*>(ui->tabWidgetSource->widget(index));
+    editor->goToLine(line, column);
+    editor->setFocus();
+}
+
 void MainWindow::addNewFile(const QString& filePath) {
     if (!filePath.isEmpty()) {
         QFile file(filePath);
@@ -409,7 +715,14 @@ void MainWindow::addNewFile(const QString& filePath) {
 }
 
 void MainWindow::onDocumentModified(TextEditor* editor) {
-    ui->tabWidgetSource->setTabText(ui->tabWidgetSource->indexOf(editor), editor->getModifiedName());
+    // Called on every keystroke, the tab is found without canonicalizing the path.
+    ui->tabWidgetSource->setTabText(findSource(editor), editor->getModifiedName());
+}
+
+void MainWindow::onFileSaved() {
+    if (Preferences::getInstance()->getCargo().checkOnSave) {
+        checkTimer->start();
+    }
 }
 
 void MainWindow::addRecentFile(const QString& filePath) {
@@ -487,6 +800,7 @@ void MainWindow::loadProjectProperties() {
 }
 
 void MainWindow::loadSettings() {
+    TRACE_SCOPE("MainWindow::loadSettings");
     // Window geometry
     int width = Settings::getValue("window.geometry.width").toInt();
     int height = Settings::getValue("window.geometry.height").toInt();
@@ -653,6 +967,7 @@ void MainWindow::saveSession() {
         cursorPosArray.append(pos.x());
         cursorPosArray.append(pos.y());
         obj["cursor"] = cursorPosArray;
+        obj["scroll"] = editor->getScrollPosition();
 
         openFiles.append(obj);
     }
@@ -666,6 +981,7 @@ void MainWindow::saveSession() {
 }
 
 void MainWindow::loadSession() {
+    TRACE_SCOPE("MainWindow::loadSession");
     if (!Settings::getValue("gui.session.restore").toBool() || projectPath.isEmpty()) {
         return;
     }
@@ -689,11 +1005,14 @@ void MainWindow::loadSession() {
     for (int i = 0; i < array.count(); i++) {
         QJsonObject obj = array.at(i).toObject();
         QString filePath = obj["path"].toString();
-        if (QFileInfo::exists(filePath)) {
-            int index = addSourceTab(filePath);
+        if (QFileInfo::exists(filePath) && findSource(filePath) == -1) {
+            // Tabs are read from disk when first activated, only the selected one is now.
+            int index = createSourceTab(filePath);
+            addRecentFile(filePath);
             QJsonArray cursorPosArray = obj["cursor"].toArray();
             TextEditor* editor = static_cast<TextEditor*>(ui->tabWidgetSource->widget(index));
             editor->setCursorPosition(QPoint(cursorPosArray.at(0).toInt(), cursorPosArray.at(1).toInt()));
+            editor->setScrollPosition(obj["scroll"].toInt());
         }
     }
 
@@ -702,11 +1021,17 @@ void MainWindow::loadSession() {
 }
 
 void MainWindow::openProject(const QString& path, bool isNew) {
+    TRACE_SCOPE("MainWindow::openProject");
     closeProject();
 
     projectPath = path;
     projectTree->setRootPath(path);
+    fileIndex->setRootPath(path, IgnoreMatcher::forProject(path));
     cargoManager->setProjectPath(path);
+    testManager->setWorkingDirectory(path);
+    profileManager->setProjectPath(path);
+    codegenView->setProjectPath(path);
+    ui->plainTextEditCargo->setLogFilePath(projectPath + "/" + Constants::PROJECT_DATA_DIRECTORY + "/" + Constants::PROJECT_OUTPUT_LOG_FILE);
 
     if (isNew) {
         QString filePath = projectPath + "/src/main.rs";
@@ -724,10 +1049,18 @@ void MainWindow::openProject(const QString& path, bool isNew) {
         loadSession();
     }
 
+    // After the project properties, which load the cached target directory.
+    benchmarkView->setCriterionPath(cargoManager->getTargetPath() + "/criterion");
+
     if (!ui->tabWidgetSource->count()) {
         changeWindowTitle();
     }
 
+    // Watch stays checked when another project is opened, start with an initial run.
+    if (ui->actionWatch->isChecked()) {
+        on_actionWatch_toggled(true);
+    }
+
     updateMenuState();
     addRecentProject(path);
 }
@@ -742,10 +1075,30 @@ void MainWindow::closeProject() {
 
     projectProperties->reset();
     projectTree->setRootPath(QString());
+    fileIndex->setRootPath(QString(), IgnoreMatcher());
     projectPath = QString();
     changeWindowTitle();
     updateMenuState();
-    ui->plainTextEditCargo->clear();
+    ui->plainTextEditCargo->clearOutput();
+    ui->plainTextEditCargo->setLogFilePath(QString());
+
+    checkTimer->stop();
+    cargoManager->cancelCheck();
+    projectWatcher->setProjectPath(QString());
+    cargoManager->cancelWatch();
+    issueList->clear();
+    ui->tabWidgetOutput->setTabText(static_cast<int>(OutputPane::Issues), tr("Issues"));
+
+    testManager->stop();
+    testExplorer->clearTests();
+    buildTimingsView->clearTimings();
+    benchmarkView->clearBenchmarks();
+
+    profileManager->stop();
+    flameGraphView->clearCallTree();
+    heapProfileView->clearProfile();
+    codegenView->clearCodegen();
+    ui->tabWidgetOutput->setTabText(static_cast<int>(OutputPane::Tests), tr("Tests"));
 }
 
 void MainWindow::changeWindowTitle(const QString& filePath) {
@@ -764,11 +1117,57 @@ void MainWindow::changeWindowTitle(const QString& filePath) {
     setWindowTitle(title);
 }
 
-int MainWindow::findSource(const QString& filePath) {
+void MainWindow::showCodegen(CodegenIndex::Kind kind) {
+    if (!editor) return;
+
+    on_actionSaveAll_triggered();
+    ui->tabWidgetOutput->setCurrentIndex(static_cast<int>(OutputPane::Codegen));
+    codegenView->showFunction(kind, editor->getFilePath(), editor->textCursor().blockNumber() + 1,
+            projectProperties->getRunTargetKind() + " " + projectProperties->getRunTargetName());
+}
+
+QString MainWindow::resolveSourcePath(const QString& filePath) const {
+    if (QDir::isAbsolutePath(filePath)) return filePath;
+
+    QString projectFilePath = QDir(projectPath).absoluteFilePath(filePath);
+    if (QFileInfo::exists(projectFilePath)) return projectFilePath;
+
+    // Profilers often print only the file name, so fall back to open tabs.
+    QString suffix = "/" + QDir::fromNativeSeparators(filePath);
     for (int i = 0; i < ui->tabWidgetSource->count(); i++) {
         TextEditor* editor = static_cast<TextEditor*>(ui->tabWidgetSource->widget(i));
-        if (editor->getFilePath() == filePath) {
-            return i;
+        if (editor->getFilePath().endsWith(suffix)) {
+            return editor->getFilePath();
+        }
+    }
+
+    return projectFilePath;
+}
+
+bool MainWindow::isPathInside(const QString& filePath, const QString& path) {
+    // A plain prefix would take "src/foo" to be inside "src/fo".
+    return filePath.startsWith(path) && (filePath.size() == path.size() || filePath.at(path.size()) == '/');
+}
+
+int MainWindow::findSource(const QString& filePath) {
+    for (TextEditor* view : DocumentRegistry::getInstance()->getViews(filePath)) {
+        int index = ui->tabWidgetSource->indexOf(view);
+        if (index != -1) {
+            return index;
+        }
+    }
+
+    return -1;
+}
+
+int MainWindow::findSource(TextEditor* editor) {
+    int index = ui->tabWidgetSource->indexOf(editor);
+    if (index != -1) return index;
+
+    for (TextEditor* view : DocumentRegistry::getInstance()->getViews(editor)) {
+        index = ui->tabWidgetSource->indexOf(view);
+        if (index != -1) {
+            return index;
         }
     }
 
@@ -789,8 +1188,14 @@ void MainWindow::updateMenuState() {
     ui->actionCloseOther->setEnabled(index >= 0);
     ui->actionCloseAll->setEnabled(index >= 0);
 
+    ui->actionGoToFile->setEnabled(!projectPath.isNull());
+    ui->actionWatch->setEnabled(!projectPath.isNull());
+    ui->actionSplitEditor->setEnabled(index >= 0);
+
     ui->menuRecentProjects->menuAction()->setEnabled(ui->menuRecentProjects->actions().size() > Constants::SEPARATOR_AND_MENU_CLEAR_COUNT);
     ui->menuRecentFiles->menuAction()->setEnabled(ui->menuRecentFiles->actions().size() > Constants::SEPARATOR_AND_MENU_CLEAR_COUNT);
 
     ui->menuEdit->menuAction()->setEnabled(index >= 0);
+
+    ui->actionTestFailed->setEnabled(testManager->hasFailedTests());
 }
@@ -1,13 +1,27 @@
 #pragma once
+#include "Process/CodegenIndex.h"
 #include <QMainWindow>
 #include <functional>
 
 class CargoManager;
+class TestManager;
+class ProfileManager;
 class ApplicationManager;
 class ProjectTree;
 class ProjectProperties;
 class TextEditor;
 class AutoCompleter;
+class IssueList;
+class TestExplorer;
+class BuildTimingsView;
+class BenchmarkView;
+class FlameGraphView;
+class HeapProfileView;
+class CodegenView;
+class ProjectWatcher;
+class FileIndex;
+class QTimer;
+class QSplitter;
 
 namespace Ui {
     class MainWindow;
@@ -31,6 +45,7 @@ private slots:
     void on_actionNewDirectory_triggered();
 
     void on_actionOpen_triggered();
+    void on_actionGoToFile_triggered();
     void on_actionCloseProject_triggered();
     void on_actionClearMenuRecentFiles_triggered();
     void on_actionClearMenuRecentProjects_triggered();
@@ -69,13 +84,27 @@ private slots:
 
     // Cargo
     void on_actionBuild_triggered();
+    void on_actionBuildWithTimings_triggered();
     void on_actionRun_triggered();
+    void on_actionTest_triggered();
+    void on_actionTestFailed_triggered();
+    void on_actionBench_triggered();
+    void on_actionProfileRun_triggered();
+    void on_actionShowAssembly_triggered();
+    void on_actionShowLlvmIr_triggered();
+    void on_actionWatch_toggled(bool checked);
+    void on_actionNextLocation_triggered();
+    void on_actionPreviousLocation_triggered();
     void on_actionStop_triggered();
     void on_actionClean_triggered();
 
     // Tools
+    void on_actionOpenHeapProfile_triggered();
     void on_actionOptions_triggered();
 
+    // View
+    void on_actionSplitEditor_toggled(bool checked);
+
     // Help
     void on_actionAbout_triggered();
 
@@ -90,7 +119,8 @@ private slots:
 
     // CargoManager
     void onProjectCreated(const QString& path);
-    void onCargoMessage(const QString& message, bool html, bool start);
+    void onCargoMessage(const QString& message, bool start);
+    void onTimingsReady(const QString& reportPath);
 
     // ProjectTree
     void onFileCreated(const QString& filePath);
@@ -98,10 +128,14 @@ private slots:
     void onFileRenamed(const QString& oldPath, const QString& newPath);
 
     int addSourceTab(const QString& filePath);
+    int createSourceTab(const QString& filePath);
     void addNewFile(const QString& filePath);
+    void openLocation(const QString& filePath, int line, int column);
 
     // Editor
     void onDocumentModified(TextEditor* editor);
+    void onFileSaved();
+    void hibernateTabs();
 
 private:
     void addRecentFile(const QString& filePath);
@@ -113,6 +147,13 @@ private:
 
     enum class OutputPane {
         Cargo,
+        Issues,
+        Tests,
+        Timings,
+        Benchmarks,
+        Profile,
+        Heap,
+        Codegen,
         Application,
         Search
     };
@@ -127,15 +168,36 @@ private:
     void closeProject();
 
     void changeWindowTitle(const QString& filePath = QString());
+    void showCodegen(CodegenIndex::Kind kind);
+    QString resolveSourcePath(const QString& filePath) const;
     int findSource(const QString& filePath);
+    // Tab of the editor's document, the editor may be the split view.
+    int findSource(TextEditor* editor);
+    static bool isPathInside(const QString& filePath, const QString& path);
     void updateMenuState();
 
     Ui::MainWindow* ui;
     CargoManager* cargoManager;
+    TestManager* testManager;
+    ProfileManager* profileManager;
     ApplicationManager* applicationManager;
     ProjectTree* projectTree;
     ProjectProperties* projectProperties;
     QString projectPath;
     TextEditor* editor = nullptr;
+    // Second view of a document next to the tabs.
+    TextEditor* splitEditor = nullptr;
+    QSplitter* splitterSource;
     AutoCompleter* completer;
+    IssueList* issueList;
+    TestExplorer* testExplorer;
+    BuildTimingsView* buildTimingsView;
+    BenchmarkView* benchmarkView;
+    FlameGraphView* flameGraphView;
+    HeapProfileView* heapProfileView;
+    CodegenView* codegenView;
+    QTimer* checkTimer;
+    QTimer* hibernateTimer;
+    ProjectWatcher* projectWatcher;
+    FileIndex* fileIndex;
 };
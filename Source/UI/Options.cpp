@@ -2,6 +2,7 @@
 #include "ui_Options.h"
 #include "Core/Global.h"
 #include "Core/Settings.h"
+#include "Core/Preferences.h"
 #include <QtWidgets>
 
 Options::Options(QWidget* parent) :
@@ -39,10 +40,18 @@ void Options::readSettings() {
     ui->lineEditCargo->setText(Settings::getValue("cargo.path").toString());
     ui->lineEditWorkspace->setText(Global::getWorkspacePath());
     ui->checkBoxSession->setChecked(Settings::getValue("gui.session.restore").toBool());
+    ui->checkBoxCheckOnSave->setChecked(Settings::getValue("cargo.checkOnSave").toBool());
+    ui->spinBoxOutputMaxLines->setValue(Settings::getValue("gui.output.maxLines").toInt());
+    ui->checkBoxOutputLog->setChecked(Settings::getValue("gui.output.logToFile").toBool());
 }
 
 void Options::writeSettings() {
     Settings::setValue("cargo.path", ui->lineEditCargo->text());
     Settings::setValue("workspace", ui->lineEditWorkspace->text());
     Settings::setValue("gui.session.restore", ui->checkBoxSession->isChecked());
+    Settings::setValue("cargo.checkOnSave", ui->checkBoxCheckOnSave->isChecked());
+    Settings::setValue("gui.output.maxLines", ui->spinBoxOutputMaxLines->value());
+    Settings::setValue("gui.output.logToFile", ui->checkBoxOutputLog->isChecked());
+
+    Preferences::getInstance()->reload();
 }
@@ -1,7 +1,21 @@
 #include "ProjectProperties.h"
 #include "ui_ProjectProperties.h"
+#include "Core/Constants.h"
+#include "Core/Global.h"
+#include "Core/Trace.h"
+#include "Process/ProcessJob.h"
+#include "Process/JobScheduler.h"
 #include <QtCore>
 
+// Manifest files of every package the cached metadata depends on.
+static const char* const MANIFEST_FILES[] = { "Cargo.toml", "Cargo.lock" };
+
+// Cargo configuration, looked up in every directory up to the root.
+static const char* const CONFIG_FILES[] = { ".cargo/config", ".cargo/config.toml" };
+
+// Directories Cargo discovers targets in when they are not declared in the manifest.
+static const char* const TARGET_DIRECTORIES[] = { "src", "src/bin", "examples", "tests", "benches" };
+
 ProjectProperties::ProjectProperties(QWidget* parent) :
         QWidget(parent),
         ui(new Ui::ProjectProperties) {
@@ -38,33 +52,314 @@ void ProjectProperties::setArguments(const QString& arguments) {
 }
 
 const QString ProjectProperties::getRunTarget() const {
-    return metadata["target_directory"].toString() + "/"
+    // Examples are built into a directory of their own.
+    return getTargetDirectory() + "/"
             + (getBuildTarget() == CargoManager::BuildTarget::Debug ? "debug" : "release") + "/"
+            + (getRunTargetKind() == "example" ? "examples/" : "")
             + ui->comboBoxRun->currentText();
 }
 
+QString ProjectProperties::getRunTargetName() const {
+    return ui->comboBoxRun->currentText();
+}
+
+QString ProjectProperties::getRunTargetKind() const {
+    for (const QJsonValue& target : getPackage()["targets"].toArray()) {
+        if (target.toObject()["name"].toString() == ui->comboBoxRun->currentText()) {
+            return target.toObject()["kind"].toArray().at(0).toString();
+        }
+    }
+
+    return QString();
+}
+
+QJsonObject ProjectProperties::getPackage() const {
+    return metadata["packages"].toArray().at(0).toObject();
+}
+
+QString ProjectProperties::getPackageName() const {
+    return getPackage()["name"].toString();
+}
+
+QString ProjectProperties::getTargetDirectory() const {
+    return metadata["target_directory"].toString();
+}
+
+QStringList ProjectProperties::getLocalPackagePaths() const {
+    QStringList paths = getMemberPaths(metadata);
+
+    // Metadata without dependencies still has the paths of path dependencies.
+    for (const QJsonValue& package : metadata["packages"].toArray()) {
+        for (const QJsonValue& dependency : package.toObject()["dependencies"].toArray()) {
+            QString path = dependency.toObject()["path"].toString();
+            if (!path.isEmpty()) {
+                paths << path;
+            }
+        }
+    }
+
+    paths.removeDuplicates();
+    return paths;
+}
+
 void ProjectProperties::reset() {
+    cancelMetadataJob();
     ui->comboBoxTarget->setCurrentIndex(0);
     projectPath = QString();
+    metadata = QJsonObject();
     ui->comboBoxRun->clear();
+    emit metadataChanged();
 }
 
 void ProjectProperties::updateMetadata() {
+    cancelMetadataJob();
+
+    // Show cached targets at once and run cargo only if the manifest has changed.
+    if (loadMetadataCache()) return;
+
     QString manifestPath = projectPath + "/Cargo.toml";
-    QProcess process;
+    // Stamped with the members known so far, new ones are added when the metadata is in.
+    QJsonObject manifest = getManifestStamp(metadata);
+
     QStringList arguments;
     arguments << "metadata";
     arguments << "--format-version" << "1";
     arguments << "--manifest-path" << manifestPath;
     arguments << "--no-deps";
-    process.start("cargo", arguments);
-    process.waitForFinished();
 
-    QJsonDocument doc(QJsonDocument::fromJson(process.readAllStandardOutput()));
-    metadata = doc.object();
+    ProcessJob* job = new ProcessJob(Global::getCargoPath(), arguments, this);
+    job->setWorkingDirectory(projectPath);
+    metadataJob = job;
+    metadataOutput.clear();
+
+    // The span covers the wait in the job queue, cargo and handling the result.
+    qint64 traceStart = Trace::begin();
+
+    connect(job, &ProcessJob::standardOutput, this, [=] (ProcessJob*, const QString& data) {
+        if (job == metadataJob) {
+            metadataOutput += data;
+        }
+    });
 
-    QJsonArray targets = metadata["packages"].toArray().at(0).toObject()["targets"].toArray();
+    connect(job, &ProcessJob::finished, this, [=] {
+        if (job == metadataJob) {
+            metadataJob = nullptr;
+
+            if (job->getExitStatus() == QProcess::NormalExit && job->getExitCode() == 0) {
+                QJsonDocument doc(QJsonDocument::fromJson(metadataOutput.toUtf8()));
+                if (doc.isObject()) {
+                    metadata = doc.object();
+                    updateRunTargets();
+                    saveMetadataCache(getManifestStamp(metadata, manifest));
+                    emit metadataChanged();
+                }
+            } else {
+                qWarning() << "Failed to get Cargo metadata for" << manifestPath;
+            }
+
+            metadataOutput.clear();
+            Trace::end("ProjectProperties::updateMetadata", traceStart);
+        }
+
+        job->deleteLater();
+    });
+
+    JobScheduler::getInstance()->enqueue(job);
+}
+
+void ProjectProperties::cancelMetadataJob() {
+    if (metadataJob) {
+        ProcessJob* job = metadataJob;
+        metadataJob = nullptr;
+        job->cancel();
+    }
+}
+
+void ProjectProperties::updateRunTargets() {
+    QString currentTarget = ui->comboBoxRun->currentText();
+    ui->comboBoxRun->clear();
+
+    QJsonArray targets = getPackage()["targets"].toArray();
     for (int i = 0; i < targets.size(); i++) {
         ui->comboBoxRun->addItem(targets.at(i).toObject()["name"].toString());
     }
+
+    int index = ui->comboBoxRun->findText(currentTarget);
+    if (index != -1) {
+        ui->comboBoxRun->setCurrentIndex(index);
+    }
+}
+
+bool ProjectProperties::loadMetadataCache() {
+    QFile file(getMetadataCachePath());
+    if (!file.exists()) return false;
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Failed to open metadata cache file for reading" << file.fileName();
+        return false;
+    }
+
+    QJsonObject cache = QJsonDocument::fromJson(file.readAll()).object();
+    file.close();
+
+    metadata = cache["metadata"].toObject();
+    updateRunTargets();
+    emit metadataChanged();
+
+    return !metadata.isEmpty() && isManifestUnchanged(cache["manifest"].toObject());
+}
+
+void ProjectProperties::saveMetadataCache(const QJsonObject& manifest) {
+    QString path = getMetadataCachePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    // Written to a temporary file and renamed, so an interrupted write can't leave a truncated cache.
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Failed to open metadata cache file for writing" << path;
+        return;
+    }
+
+    QJsonObject cache;
+    cache["manifest"] = manifest;
+    cache["metadata"] = metadata;
+
+    QJsonDocument doc(cache);
+    file.write(doc.toJson(QJsonDocument::Compact));
+    if (!file.commit()) {
+        qWarning() << "Failed to write metadata cache file" << path << file.errorString();
+    }
+}
+
+QJsonObject ProjectProperties::getManifestStamp(const QJsonObject& cargoMetadata, const QJsonObject& previous) const {
+    // Files stamped before cargo metadata ran keep that stamp, so changes made
+    // while it was running are noticed next time.
+    QJsonObject previousFiles = previous["files"].toObject();
+    QJsonObject files;
+    for (const QString& path : getManifestFiles(cargoMetadata)) {
+        files[path] = previousFiles.contains(path) ? previousFiles.value(path) : QJsonValue(getFileStamp(path));
+    }
+
+    QStringList packagePaths = getMemberPaths(cargoMetadata);
+    QJsonArray packages = QJsonArray::fromStringList(packagePaths);
+    bool samePackages = previous["packages"].toArray() == packages;
+
+    QJsonObject manifest;
+    manifest["files"] = files;
+    manifest["packages"] = packages;
+    manifest["layout"] = samePackages ? previous["layout"].toString() : getLayoutHash(packagePaths);
+
+    return manifest;
+}
+
+bool ProjectProperties::isManifestUnchanged(const QJsonObject& manifest) const {
+    QJsonObject files = manifest["files"].toObject();
+    if (files.isEmpty()) return false;
+
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it) {
+        QFileInfo fi(it.key());
+        QJsonObject stamp = it.value().toObject();
+
+        if (!fi.exists() || stamp.isEmpty()) {
+            // Unchanged only if the file is still absent.
+            if (fi.exists() || !stamp.isEmpty()) return false;
+            continue;
+        }
+
+        // Cheap check first, hash only if the file was touched.
+        if (stamp["modified"].toString() == QString::number(fi.lastModified().toMSecsSinceEpoch())
+                && stamp["size"].toString() == QString::number(fi.size())) {
+            continue;
+        }
+
+        if (getFileStamp(it.key())["hash"].toString() != stamp["hash"].toString()) return false;
+    }
+
+    QStringList packagePaths;
+    for (const QJsonValue& value : manifest["packages"].toArray()) {
+        packagePaths << value.toString();
+    }
+
+    return manifest["layout"].toString() == getLayoutHash(packagePaths);
+}
+
+QStringList ProjectProperties::getMemberPaths(const QJsonObject& cargoMetadata) const {
+    QStringList paths;
+    paths << projectPath;
+
+    QString workspaceRoot = cargoMetadata["workspace_root"].toString();
+    if (!workspaceRoot.isEmpty()) {
+        paths << workspaceRoot;
+    }
+
+    for (const QJsonValue& package : cargoMetadata["packages"].toArray()) {
+        paths << QFileInfo(package.toObject()["manifest_path"].toString()).absolutePath();
+    }
+
+    paths.removeDuplicates();
+    return paths;
+}
+
+QStringList ProjectProperties::getManifestFiles(const QJsonObject& cargoMetadata) const {
+    QStringList files;
+
+    for (const QString& path : getMemberPaths(cargoMetadata)) {
+        for (const char* name : MANIFEST_FILES) {
+            files << path + "/" + name;
+        }
+    }
+
+    // Cargo reads its configuration, e.g. build.target-dir, from every
+    // directory up to the root and from Cargo home. Absent files are stamped too.
+    QDir dir(projectPath);
+    do {
+        for (const char* name : CONFIG_FILES) {
+            files << dir.absoluteFilePath(name);
+        }
+    } while (dir.cdUp());
+
+    QString cargoHome = QString::fromLocal8Bit(qgetenv("CARGO_HOME"));
+    if (cargoHome.isEmpty()) {
+        cargoHome = QDir::homePath() + "/.cargo";
+    }
+
+    for (const char* name : CONFIG_FILES) {
+        files << cargoHome + "/" + QFileInfo(name).fileName();
+    }
+
+    files.removeDuplicates();
+    return files;
+}
+
+QJsonObject ProjectProperties::getFileStamp(const QString& path) {
+    QJsonObject stamp;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) return stamp;
+
+    QFileInfo fi(file);
+    stamp["modified"] = QString::number(fi.lastModified().toMSecsSinceEpoch());
+    stamp["size"] = QString::number(fi.size());
+    stamp["hash"] = QString(QCryptographicHash::hash(file.readAll(), QCryptographicHash::Sha1).toHex());
+
+    return stamp;
+}
+
+QString ProjectProperties::getLayoutHash(const QStringList& packagePaths) {
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+
+    for (const QString& packagePath : packagePaths) {
+        for (const char* name : TARGET_DIRECTORIES) {
+            QDir dir(packagePath + "/" + name);
+            for (const QString& entry : dir.entryList(QDir::AllEntries | QDir::NoDotAndDotDot, QDir::Name)) {
+                hash.addData((dir.path() + "/" + entry + "\n").toUtf8());
+            }
+        }
+    }
+
+    return hash.result().toHex();
+}
+
+QString ProjectProperties::getMetadataCachePath() const {
+    return projectPath + "/" + Constants::PROJECT_DATA_DIRECTORY + "/" + Constants::PROJECT_METADATA_FILE;
 }
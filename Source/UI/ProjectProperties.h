@@ -3,6 +3,8 @@
 #include "Process/CargoManager.h"
 #include <QJsonObject>
 
+class ProcessJob;
+
 namespace Ui {
     class ProjectProperties;
 }
@@ -18,6 +20,16 @@ public:
     void setBuildTarget(CargoManager::BuildTarget buildTarget);
 
     const QString getRunTarget() const;
+    QString getRunTargetName() const;
+    // Kind of the run target as reported by Cargo, e.g. bin, example or lib.
+    QString getRunTargetKind() const;
+    // The package of the project from cargo metadata.
+    QJsonObject getPackage() const;
+    QString getPackageName() const;
+    QString getTargetDirectory() const;
+    // Directories of the workspace, its members and their path dependencies.
+    QStringList getLocalPackagePaths() const;
+    const QJsonObject& getMetadata() const { return metadata; }
     void setProject(const QString& projectPath);
 
     QString getArguments() const;
@@ -27,8 +39,26 @@ public:
     void reset();
     void updateMetadata();
 
+signals:
+    void metadataChanged();
+
 private:
+    void cancelMetadataJob();
+    void updateRunTargets();
+    bool loadMetadataCache();
+    void saveMetadataCache(const QJsonObject& manifest);
+    QJsonObject getManifestStamp(const QJsonObject& cargoMetadata, const QJsonObject& previous = QJsonObject()) const;
+    bool isManifestUnchanged(const QJsonObject& manifest) const;
+    // The project, the workspace root and the members.
+    QStringList getMemberPaths(const QJsonObject& cargoMetadata) const;
+    QStringList getManifestFiles(const QJsonObject& cargoMetadata) const;
+    static QJsonObject getFileStamp(const QString& path);
+    static QString getLayoutHash(const QStringList& packagePaths);
+    QString getMetadataCachePath() const;
+
     Ui::ProjectProperties* ui;
     QString projectPath;
     QJsonObject metadata;
+    ProcessJob* metadataJob = nullptr;
+    QString metadataOutput;
 };
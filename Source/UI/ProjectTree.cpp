@@ -2,8 +2,12 @@
 #include "FileSystemProxyModel.h"
 #include "NewName.h"
 #include "Rename.h"
+#include "Core/FileOperation.h"
 #include <QtWidgets>
 
+// Quick operations finish without a progress dialog flashing up.
+static const int PROGRESS_DELAY = 500;
+
 ProjectTree::ProjectTree(QWidget* parent) : QTreeView(parent) {
     setContextMenuPolicy(Qt::CustomContextMenu);
     connect(this, &QTreeView::customContextMenuRequested, this, &ProjectTree::onCustomContextMenu);
@@ -57,6 +61,9 @@ void ProjectTree::setRootPath(const QString& path) {
     if (path.isNull()) {
         setModel(nullptr);
     } else {
+        // Set before the root, so excluded directories are never listed.
+        fsProxyModel->setExclusion(path, IgnoreMatcher::forProject(path));
+
         setModel(fsProxyModel);
         QModelIndex index = fsModel->setRootPath(path);
         setRootIndex(fsProxyModel->mapFromSource(index));
@@ -126,19 +133,27 @@ void ProjectTree::onFileRemove() {
     int result = QMessageBox::question(this, tr("Remove"), text);
     if (result == QMessageBox::Yes) {
         QString path = fsModel->filePath(index);
-        QDir dir(path);
-        bool success = false;
-        if (isDir) {
-            success = dir.removeRecursively();
-        } else {
-            success = dir.remove(path);
-        }
-
-        if (success) {
-            emit removeActivated(path);
-        } else {
-            qWarning() << "Failed to remove" << path;
-        }
+        FileOperation* operation = FileOperation::remove(path);
+
+        QProgressDialog* progressDialog = new QProgressDialog(tr("Removing \"%1\"...").arg(fsModel->fileName(index)), tr("Cancel"), 0, 0, this);
+        progressDialog->setWindowModality(Qt::WindowModal);
+        progressDialog->setMinimumDuration(PROGRESS_DELAY);
+        connect(progressDialog, &QProgressDialog::canceled, operation, &FileOperation::cancel);
+
+        connect(operation, &FileOperation::progress, progressDialog, [=] (int done, int total) {
+            progressDialog->setMaximum(total);
+            progressDialog->setValue(done);
+        });
+
+        connect(operation, &FileOperation::finished, this, [=] (bool success) {
+            progressDialog->deleteLater();
+            // After a cancel some entries are gone, tabs of those are kept like any deleted file.
+            if (success) {
+                emit removeActivated(path);
+            }
+        });
+
+        operation->start();
     }
 }
 
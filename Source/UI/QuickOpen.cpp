@@ -0,0 +1,76 @@
+#include "QuickOpen.h"
+#include "ui_QuickOpen.h"
+#include "Core/FileIndex.h"
+#include <QtWidgets>
+
+static const int MAX_RESULTS = 50;
+
+QuickOpen::QuickOpen(FileIndex* fileIndex, QWidget* parent) :
+        QDialog(parent),
+        ui(new Ui::QuickOpen),
+        fileIndex(fileIndex) {
+    ui->setupUi(this);
+    ui->lineEdit->installEventFilter(this);
+    connect(fileIndex, &FileIndex::updated, this, &QuickOpen::updateResults);
+    updateResults();
+}
+
+QuickOpen::~QuickOpen() {
+    delete ui;
+}
+
+QString QuickOpen::getFilePath() const {
+    QListWidgetItem* item = ui->listWidget->currentItem();
+    if (!item) return QString();
+
+    return fileIndex->getRootPath() + "/" + item->text();
+}
+
+bool QuickOpen::eventFilter(QObject* watched, QEvent* event) {
+    if (watched == ui->lineEdit && event->type() == QEvent::KeyPress) {
+        // Keep typing in the line edit while moving through the results.
+        QKeyEvent* keyEvent = static_cast<QKeyEvent*>(event);
+        switch (keyEvent->key()) {
+            case Qt::Key_Up:
+            case Qt::Key_Down:
+            case Qt::Key_PageUp:
+            case Qt::Key_PageDown:
+                QApplication::sendEvent(ui->listWidget, event);
+                return true;
+            case Qt::Key_Return:
+            case Qt::Key_Enter:
+                if (ui->listWidget->currentItem()) {
+                    accept();
+                }
+                return true;
+            default:
+                break;
+        }
+    }
+
+    return QDialog::eventFilter(watched, event);
+}
+
+void QuickOpen::on_lineEdit_textChanged(const QString& text) {
+    Q_UNUSED(text)
+    updateResults();
+}
+
+void QuickOpen::on_listWidget_itemActivated() {
+    accept();
+}
+
+void QuickOpen::updateResults() {
+    ui->listWidget->clear();
+    ui->listWidget->addItems(fileIndex->match(ui->lineEdit->text(), MAX_RESULTS));
+
+    if (ui->listWidget->count()) {
+        ui->listWidget->setCurrentRow(0);
+    }
+
+    if (!fileIndex->isReady()) {
+        ui->labelStatus->setText(tr("Indexing..."));
+    } else {
+        ui->labelStatus->setText(tr("%1 files").arg(fileIndex->getFileCount()));
+    }
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <QDialog>
+
+class FileIndex;
+
+namespace Ui {
+    class QuickOpen;
+}
+
+class QuickOpen : public QDialog {
+    Q_OBJECT
+
+public:
+    explicit QuickOpen(FileIndex* fileIndex, QWidget* parent = 0);
+    ~QuickOpen();
+    QString getFilePath() const;
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private slots:
+    void on_lineEdit_textChanged(const QString& text);
+    void on_listWidget_itemActivated();
+    void updateResults();
+
+private:
+    Ui::QuickOpen* ui;
+    FileIndex* fileIndex;
+};
@@ -0,0 +1,113 @@
+#include "TestExplorer.h"
+#include <QtWidgets>
+
+enum Columns {
+    NameColumn,
+    StatusColumn,
+    DurationColumn
+};
+
+// Long panic messages and backtraces are cut in tooltips.
+static const int MAX_TOOLTIP_LENGTH = 4000;
+
+TestExplorer::TestExplorer(QWidget* parent) : QTreeWidget(parent) {
+    setFrameShape(QFrame::NoFrame);
+    setUniformRowHeights(true);
+    setHeaderLabels(QStringList() << tr("Test") << tr("Status") << tr("Duration"));
+    header()->setSectionResizeMode(NameColumn, QHeaderView::Stretch);
+    header()->setStretchLastSection(false);
+}
+
+void TestExplorer::setTests(const QVector<TestManager::Test>& tests) {
+    setUpdatesEnabled(false);
+
+    clearTests();
+    for (const TestManager::Test& test : tests) {
+        setStatus(findOrCreateItem(test.target, test.name), TestManager::Status::Pending);
+    }
+
+    setUpdatesEnabled(true);
+}
+
+void TestExplorer::clearTests() {
+    clear();
+    items.clear();
+}
+
+void TestExplorer::onTestStarted(const QString& target, const QString& name) {
+    setStatus(findOrCreateItem(target, name), TestManager::Status::Running);
+}
+
+void TestExplorer::onTestFinished(const QString& target, const QString& name, TestManager::Status status, qint64 duration) {
+    QTreeWidgetItem* item = findOrCreateItem(target, name);
+    setStatus(item, status);
+    item->setText(DurationColumn, duration < 0 ? QString() : QString("%1 ms").arg(duration));
+
+    if (status == TestManager::Status::Failed) {
+        // Mark and reveal the modules and the binary containing the failed test.
+        for (QTreeWidgetItem* parent = item->parent(); parent; parent = parent->parent()) {
+            parent->setForeground(NameColumn, item->foreground(NameColumn));
+            parent->setExpanded(true);
+        }
+    }
+}
+
+void TestExplorer::onTestOutput(const QString& target, const QString& name, const QString& output) {
+    QTreeWidgetItem* item = findOrCreateItem(target, name);
+    QString toolTip = output.size() > MAX_TOOLTIP_LENGTH ? output.left(MAX_TOOLTIP_LENGTH) + "\n..." : output;
+    item->setToolTip(NameColumn, toolTip);
+}
+
+QTreeWidgetItem* TestExplorer::findOrCreateItem(const QString& target, const QString& name) {
+    QString key = target + '\n' + name;
+    QTreeWidgetItem* item = items.value(key);
+    if (item) return item;
+
+    item = new QTreeWidgetItem;
+
+    if (name.isEmpty()) {
+        // "--lib", "--bin name"... shown as "lib", "bin name".
+        item->setText(NameColumn, target.mid(2));
+        addTopLevelItem(item);
+    } else {
+        // Doctest names are "src/lib.rs - path::to::item (line 3)", not module paths.
+        int separator = target == "--doc" ? -1 : name.lastIndexOf("::");
+        QTreeWidgetItem* parent = findOrCreateItem(target, separator == -1 ? QString() : name.left(separator));
+        item->setText(NameColumn, separator == -1 ? name : name.mid(separator + 2));
+        parent->addChild(item);
+    }
+
+    items[key] = item;
+
+    return item;
+}
+
+void TestExplorer::setStatus(QTreeWidgetItem* item, TestManager::Status status) {
+    QString text;
+    QColor color;
+
+    switch (status) {
+        case TestManager::Status::Pending:
+            break;
+        case TestManager::Status::Running:
+            text = tr("running");
+            color = QColor("#0451a5");
+            break;
+        case TestManager::Status::Passed:
+            text = tr("ok");
+            color = QColor("#00bc00");
+            break;
+        case TestManager::Status::Failed:
+            text = tr("FAILED");
+            color = QColor("#cd3131");
+            break;
+        case TestManager::Status::Ignored:
+            text = tr("ignored");
+            color = QColor("#949800");
+            break;
+    }
+
+    item->setText(StatusColumn, text);
+    item->setForeground(NameColumn, color.isValid() ? QBrush(color) : QBrush());
+    item->setForeground(StatusColumn, color.isValid() ? QBrush(color) : QBrush());
+}
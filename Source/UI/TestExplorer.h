@@ -0,0 +1,27 @@
+#pragma once
+#include "Process/TestManager.h"
+#include <QTreeWidget>
+
+// Tree of tests grouped by test binary and module path, updated while tests are running.
+class TestExplorer : public QTreeWidget {
+    Q_OBJECT
+
+public:
+    explicit TestExplorer(QWidget* parent = nullptr);
+
+    void setTests(const QVector<TestManager::Test>& tests);
+    void clearTests();
+
+public slots:
+    void onTestStarted(const QString& target, const QString& name);
+    void onTestFinished(const QString& target, const QString& name, TestManager::Status status, qint64 duration);
+    void onTestOutput(const QString& target, const QString& name, const QString& output);
+
+private:
+    // An empty name is the item of the test binary itself.
+    QTreeWidgetItem* findOrCreateItem(const QString& target, const QString& name);
+    void setStatus(QTreeWidgetItem* item, TestManager::Status status);
+
+    // Keyed by target and name, separated by a newline.
+    QHash<QString, QTreeWidgetItem*> items;
+};
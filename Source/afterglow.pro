@@ -21,12 +21,41 @@ SOURCES += \
     UI/FileSystemProxyModel.cpp \
     UI/ProjectTree.cpp \
     Core/Settings.cpp \
+    Core/IgnoreMatcher.cpp \
+    Core/FileIndex.cpp \
+    Core/FileOperation.cpp \
+    Core/Preferences.cpp \
+    Core/ProjectWatcher.cpp \
+    Core/Trace.cpp \
     Process/ProcessManager.cpp \
     Process/CargoManager.cpp \
+    Process/ProcessJob.cpp \
+    Process/ProcessWorker.cpp \
+    Process/JobScheduler.cpp \
+    Process/TestManager.cpp \
+    Process/BuildTimings.cpp \
+    Process/CallTree.cpp \
+    Process/ProfileManager.cpp \
+    Process/HeapProfile.cpp \
+    Process/CodegenIndex.cpp \
     TextEditor/AutoCompleter.cpp \
     TextEditor/TextEditor.cpp \
     TextEditor/SyntaxHighlightManager.cpp \
-    UI/GoToLine.cpp
+    TextEditor/DocumentRegistry.cpp \
+    UI/GoToLine.cpp \
+    UI/QuickOpen.cpp \
+    UI/ConsoleOutput.cpp \
+    UI/AnsiEscapeParser.cpp \
+    UI/IssueList.cpp \
+    UI/TestExplorer.cpp \
+    UI/BuildTimingsView.cpp \
+    UI/BenchmarkModel.cpp \
+    UI/BenchmarkView.cpp \
+    UI/FlameGraph.cpp \
+    UI/FlameGraphView.cpp \
+    UI/HeapProfileModel.cpp \
+    UI/HeapProfileView.cpp \
+    UI/CodegenView.cpp
 
 HEADERS += \
     UI/MainWindow.h \
@@ -43,13 +72,42 @@ HEADERS += \
     UI/FileSystemProxyModel.h \
     UI/ProjectTree.h \
     Core/Settings.h \
+    Core/IgnoreMatcher.h \
+    Core/FileIndex.h \
+    Core/FileOperation.h \
+    Core/Preferences.h \
+    Core/ProjectWatcher.h \
     Core/Singleton.h \
+    Core/Trace.h \
     Process/ProcessManager.h \
     Process/CargoManager.h \
+    Process/ProcessJob.h \
+    Process/ProcessWorker.h \
+    Process/JobScheduler.h \
+    Process/TestManager.h \
+    Process/BuildTimings.h \
+    Process/CallTree.h \
+    Process/ProfileManager.h \
+    Process/HeapProfile.h \
+    Process/CodegenIndex.h \
     TextEditor/AutoCompleter.h \
     TextEditor/TextEditor.h \
     TextEditor/SyntaxHighlightManager.h \
-    UI/GoToLine.h
+    TextEditor/DocumentRegistry.h \
+    UI/GoToLine.h \
+    UI/QuickOpen.h \
+    UI/ConsoleOutput.h \
+    UI/AnsiEscapeParser.h \
+    UI/IssueList.h \
+    UI/TestExplorer.h \
+    UI/BuildTimingsView.h \
+    UI/BenchmarkModel.h \
+    UI/BenchmarkView.h \
+    UI/FlameGraph.h \
+    UI/FlameGraphView.h \
+    UI/HeapProfileModel.h \
+    UI/HeapProfileView.h \
+    UI/CodegenView.h
 
 FORMS += \
     UI/MainWindow.ui \
@@ -59,7 +117,8 @@ FORMS += \
     UI/NewName.ui \
     UI/ProjectProperties.ui \
     UI/Rename.ui \
-    UI/GoToLine.ui
+    UI/GoToLine.ui \
+    UI/QuickOpen.ui
 
 DISTFILES += \
     ../README.md \
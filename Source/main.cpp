@@ -2,9 +2,13 @@
 #include "UI/SelectWorkspace.h"
 #include "Core/Constants.h"
 #include "Core/Settings.h"
+#include "Core/Preferences.h"
 #include "Core/Global.h"
+#include "Core/Trace.h"
 #include <QApplication>
 #include <QSettings>
+#include <QCommandLineParser>
+#include <QTimer>
 
 int main(int argc, char *argv[]) {
     QApplication app(argc, argv);
@@ -12,15 +16,38 @@ int main(int argc, char *argv[]) {
     app.setApplicationName(Constants::APP_NAME);
     app.setApplicationVersion(Constants::APP_VERSION);
 
+    QCommandLineParser parser;
+    QCommandLineOption traceOption("trace", QCoreApplication::translate("main", "Write a Chrome trace of startup and editor operations to <file>."), "file");
+    parser.addOption(traceOption);
+    // Unknown arguments are left to Qt.
+    parser.parse(app.arguments());
+
+    if (parser.isSet(traceOption)) {
+        Trace::start(parser.value(traceOption));
+    }
+
     Settings::init();
+    Preferences preferences;
 
     MainWindow window;
-    window.show();
+
+    {
+        TRACE_SCOPE("MainWindow::show");
+        window.show();
+    }
+
+    // The window is usable from here.
+    QTimer::singleShot(0, [] {
+        Trace::mark("Event loop started");
+    });
 
     if (Settings::getValue("workspace").toString().isEmpty()) {
         SelectWorkspace selectWorkspace(&window);
         selectWorkspace.exec();
     }
 
-    return app.exec();
+    int result = app.exec();
+    Trace::stop();
+
+    return result;
 }